@@ -147,7 +147,10 @@ fsst_decompress(
       FSST_UNALIGNED_STORE(strOut+posOut, symbol[code1]); 
       posOut += len[code1];
    }
-   if (posOut+8 <= size && posIn < lenIn) {
+   // MODIFIED: Only a single trailing code is decoded here, a trailing pair of
+   // codes (3 bytes) is left to the loop below
+   if (posOut+8 <= size && posIn+2 == lenIn) {
+   // END OF MODIFIED
       unsigned short code;
       memcpy(&code, strIn+posIn, sizeof(unsigned short));
       code &= 4095;
@@ -156,9 +159,11 @@ fsst_decompress(
       posOut += len[code];
    }
 #endif
-   while (posIn+3 < lenIn) {
-      unsigned int code, code0, code1;
-      memcpy(&code, strIn+posIn, sizeof(unsigned int));
+   // MODIFIED: Also decode the last pair of codes (only its 3 bytes are read)
+   while (posIn+3 <= lenIn) {
+      unsigned int code = 0, code0, code1;
+      memcpy(&code, strIn+posIn, 3);
+   // END OF MODIFIED
       code0 = code & 4095;
       code1 = (code >> 12) & 4095;
       posIn += 3;
@@ -0,0 +1,187 @@
+using namespace std;
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "aho_corasick.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class AhoCorasick
+// ---------------------------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------------------
+// Private functions
+// -----------------------------------------------------------------------------------------
+
+uint32_t AhoCorasick::getChild(uint32_t state, char symbol) const
+{
+  // The children of the root are indexed directly
+  if (state == 0)
+    return this->root_children[(unsigned char)symbol];
+
+  // Search the siblings for the symbol
+  for (uint32_t child = this->first_children[state]; child != NO_STATE;
+       child = this->next_siblings[child])
+    if (this->symbols[child] == symbol)
+      return child;
+
+  return NO_STATE;
+}
+
+uint32_t AhoCorasick::addChild(uint32_t state, char symbol)
+{
+  // Create the child
+  uint32_t child = this->symbols.size();
+  this->symbols.push_back(symbol);
+  this->first_children.push_back(NO_STATE);
+  this->next_siblings.push_back(this->first_children[state]);
+  this->depths.push_back(this->depths[state] + 1);
+  this->patterns_ending.push_back(NO_PATTERN);
+
+  // Link it to its parent
+  this->first_children[state] = child;
+  if (state == 0)
+    this->root_children[(unsigned char)symbol] = child;
+
+  return child;
+}
+
+uint32_t AhoCorasick::getTransition(uint32_t state, char symbol) const
+{
+  // Fall back to shorter suffixes until one can be extended by the symbol
+  uint32_t child = this->getChild(state, symbol);
+  while (child == NO_STATE && state != 0)
+  {
+    state = this->failures[state];
+    child = this->getChild(state, symbol);
+  }
+
+  return child == NO_STATE ? 0 : child;
+}
+
+// -----------------------------------------------------------------------------------------
+// Public functions
+// -----------------------------------------------------------------------------------------
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+AhoCorasick::AhoCorasick(const vector<string_view> &patterns)
+    : symbols(1, 0), first_children(1, NO_STATE), next_siblings(1, NO_STATE),
+      depths(1, 0), patterns_ending(1, NO_PATTERN),
+      equal_patterns(patterns.size(), NO_PATTERN), stamp(0)
+{
+  fill(this->root_children, this->root_children + 256, NO_STATE);
+
+  // Insert the patterns into the trie (equal patterns share their state)
+  for (uint32_t i = patterns.size(); i-- > 0;)
+  {
+    uint32_t state = 0;
+    for (char symbol : patterns[i])
+    {
+      uint32_t child = this->getChild(state, symbol);
+      state = child != NO_STATE ? child : this->addChild(state, symbol);
+    }
+
+    this->equal_patterns[i] = this->patterns_ending[state];
+    this->patterns_ending[state] = i;
+  }
+
+  // Link the states in breadth-first order, so the failure of a state is
+  // linked before the state itself
+  this->failures.assign(this->symbols.size(), 0);
+  this->outputs.assign(this->symbols.size(), NO_STATE);
+  vector<uint32_t> queue;
+  for (uint32_t child = this->first_children[0]; child != NO_STATE;
+       child = this->next_siblings[child])
+    queue.push_back(child);
+
+  for (size_t i = 0; i < queue.size(); i++)
+  {
+    uint32_t state = queue[i];
+    for (uint32_t child = this->first_children[state]; child != NO_STATE;
+         child = this->next_siblings[child])
+    {
+      // The longest proper suffix of the child extends a suffix of the state
+      uint32_t failure =
+          this->getTransition(this->failures[state], this->symbols[child]);
+      this->failures[child] = failure;
+      this->outputs[child] = this->patterns_ending[failure] != NO_PATTERN &&
+                                     failure != 0
+                                 ? failure
+                                 : this->outputs[failure];
+      queue.push_back(child);
+    }
+  }
+
+  this->stamps.assign(this->symbols.size(), 0);
+}
+
+// --------------------------------------------------
+// Search
+// --------------------------------------------------
+
+vector<uint32_t> AhoCorasick::getContainedPatterns(string_view text)
+{
+  vector<uint32_t> contained;
+
+  // Start a new search (resetting the stamps when they wrap around)
+  if (++this->stamp == 0)
+  {
+    fill(this->stamps.begin(), this->stamps.end(), 0);
+    this->stamp = 1;
+  }
+
+  // Report all patterns ending at a state
+  auto report = [&](uint32_t state)
+  {
+    this->stamps[state] = this->stamp;
+    for (uint32_t pattern = this->patterns_ending[state]; pattern != NO_PATTERN;
+         pattern = this->equal_patterns[pattern])
+      contained.push_back(pattern);
+  };
+
+  // Empty patterns occur in every text
+  report(0);
+
+  uint32_t state = 0;
+  for (char symbol : text)
+  {
+    state = this->getTransition(state, symbol);
+
+    // Report the patterns ending here (the rest of the chain was reported
+    // with the first state on it that was reported before)
+    uint32_t output = this->patterns_ending[state] != NO_PATTERN
+                          ? state
+                          : this->outputs[state];
+    for (; output != NO_STATE && this->stamps[output] != this->stamp;
+         output = this->outputs[output])
+      report(output);
+  }
+
+  return contained;
+}
+
+size_t AhoCorasick::find(string_view text, size_t pos) const
+{
+  // Empty patterns occur at the start
+  if (this->patterns_ending[0] != NO_PATTERN)
+    return pos <= text.length() ? pos : string_view::npos;
+
+  uint32_t state = 0;
+  for (size_t i = pos; i < text.length(); i++)
+  {
+    state = this->getTransition(state, text[i]);
+
+    // The longest pattern ending here starts first
+    uint32_t output = this->patterns_ending[state] != NO_PATTERN
+                          ? state
+                          : this->outputs[state];
+    if (output != NO_STATE)
+      return i + 1 - this->depths[output];
+  }
+
+  return string_view::npos;
+}
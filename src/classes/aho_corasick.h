@@ -0,0 +1,165 @@
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+using namespace std;
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// ---------------------------------------------------------------------------------------------
+// Class AhoCorasick
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @class AhoCorasick
+ * @brief Aho-Corasick automaton over a set of patterns.
+ *
+ * The states are the prefixes of the patterns (a trie), every state links to
+ * the state of its longest proper suffix. Walking a text through the
+ * automaton finds the occurrences of all patterns in O(length of the text +
+ * number of reported matches); construction takes O(total length of the
+ * patterns * alphabet size) in the worst case.
+ */
+class AhoCorasick
+{
+private:
+  /**
+   * @brief The symbol leading to every state (from its parent).
+   */
+  vector<char> symbols;
+
+  /**
+   * @brief The first child of every state (NO_STATE if none).
+   */
+  vector<uint32_t> first_children;
+
+  /**
+   * @brief The next sibling of every state (NO_STATE if none).
+   */
+  vector<uint32_t> next_siblings;
+
+  /**
+   * @brief The children of the root by symbol (the root is visited most).
+   */
+  uint32_t root_children[256];
+
+  /**
+   * @brief The state of the longest proper suffix of every state.
+   */
+  vector<uint32_t> failures;
+
+  /**
+   * @brief The nearest state on the failure chain of every state (excluding
+   * itself and the root) at which a pattern ends (NO_STATE if none).
+   */
+  vector<uint32_t> outputs;
+
+  /**
+   * @brief The length of the prefix of every state.
+   */
+  vector<uint32_t> depths;
+
+  /**
+   * @brief The first pattern ending at every state (NO_PATTERN if none).
+   */
+  vector<uint32_t> patterns_ending;
+
+  /**
+   * @brief The next pattern that is equal to a pattern (NO_PATTERN if none).
+   */
+  vector<uint32_t> equal_patterns;
+
+  /**
+   * @brief The search every state was last reported in (to report every
+   * state once per search).
+   */
+  vector<uint32_t> stamps;
+
+  /**
+   * @brief The current search.
+   */
+  uint32_t stamp;
+
+  /**
+   * @brief Gets the child of a state.
+   * @param state The state.
+   * @param symbol The symbol leading to the child.
+   * @return The child (NO_STATE if there is none).
+   */
+  uint32_t getChild(uint32_t state, char symbol) const;
+
+  /**
+   * @brief Adds a child to a state.
+   * @param state The state.
+   * @param symbol The symbol leading to the child.
+   * @return The new child.
+   */
+  uint32_t addChild(uint32_t state, char symbol);
+
+  /**
+   * @brief Gets the state reached from a state with a symbol (following the
+   * failure links until a state has a child for the symbol).
+   * @param state The state.
+   * @param symbol The next symbol of the text.
+   * @return The next state.
+   */
+  uint32_t getTransition(uint32_t state, char symbol) const;
+
+public:
+  /**
+   * @brief Marks a missing state.
+   */
+  static constexpr uint32_t NO_STATE = UINT32_MAX;
+
+  /**
+   * @brief Marks a missing pattern.
+   */
+  static constexpr uint32_t NO_PATTERN = UINT32_MAX;
+
+  // --------------------------------------------------
+  // Constructor
+  // --------------------------------------------------
+
+  /**
+   * @brief Constructs the automaton over a set of patterns.
+   * @param patterns The patterns (are not referenced after construction, may
+   * contain equal patterns).
+   */
+  AhoCorasick(const vector<string_view> &patterns);
+
+  // --------------------------------------------------
+  // Getters
+  // --------------------------------------------------
+
+  /**
+   * @brief Gets the number of states (including the root).
+   * @return The number of states.
+   */
+  unsigned int getNrStates() const { return this->failures.size(); }
+
+  // --------------------------------------------------
+  // Search
+  // --------------------------------------------------
+
+  /**
+   * @brief Gets all patterns that occur in a text. Takes O(length of the text
+   * + number of distinct patterns found).
+   * @param text The text to search in.
+   * @return The indices of the patterns found, each once (in no particular
+   * order).
+   */
+  vector<uint32_t> getContainedPatterns(string_view text);
+
+  /**
+   * @brief Finds the occurrence of a pattern in a text that ends first
+   * (starting at a position). With a single pattern this is
+   * string_view::find().
+   * @param text The text to search in.
+   * @param pos The position to start searching at.
+   * @return The start of the occurrence (string_view::npos if there is none).
+   */
+  size_t find(string_view text, size_t pos = 0) const;
+};
+
+#endif
@@ -0,0 +1,347 @@
+using namespace std;
+
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "child_index.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class ChildPools
+// ---------------------------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------------------
+// Private functions
+// -----------------------------------------------------------------------------------------
+
+void ChildPools::convert(ChildIndex &index, uint8_t kind)
+{
+  // Save all children before the old block is released
+  uint8_t keys[256];
+  uint32_t ids[256];
+  unsigned int count = index.count;
+  this->collect(index, keys, ids);
+
+  // Release the old block and build the new layout
+  this->clear(index);
+  index.kind = kind;
+  index.count = count;
+
+  switch (kind)
+  {
+  case ChildIndex::EMPTY:
+    break;
+  case ChildIndex::SINGLE:
+    index.key = keys[0];
+    index.ref = ids[0];
+    break;
+  case ChildIndex::N4:
+  {
+    index.ref = this->pool4.allocate();
+    Block4 &block = this->pool4.blocks[index.ref];
+    memcpy(block.keys, keys, count);
+    memcpy(block.ids, ids, count * sizeof(uint32_t));
+    break;
+  }
+  case ChildIndex::N16:
+  {
+    index.ref = this->pool16.allocate();
+    Block16 &block = this->pool16.blocks[index.ref];
+    memcpy(block.keys, keys, count);
+    memcpy(block.ids, ids, count * sizeof(uint32_t));
+    break;
+  }
+  case ChildIndex::N48:
+  {
+    index.ref = this->pool48.allocate();
+    Block48 &block = this->pool48.blocks[index.ref];
+    memset(block.slots, 0, sizeof(block.slots));
+    for (unsigned int i = 0; i < count; i++)
+      block.slots[keys[i]] = i + 1;
+    memcpy(block.keys, keys, count);
+    memcpy(block.ids, ids, count * sizeof(uint32_t));
+    break;
+  }
+  case ChildIndex::N256:
+  {
+    index.ref = this->pool256.allocate();
+    Block256 &block = this->pool256.blocks[index.ref];
+    for (unsigned int i = 0; i < 256; i++)
+      block.ids[i] = NO_CHILD;
+    for (unsigned int i = 0; i < count; i++)
+      block.ids[keys[i]] = ids[i];
+    memcpy(block.keys, keys, count);
+    break;
+  }
+  }
+}
+
+void ChildPools::collect(const ChildIndex &index, uint8_t *keys,
+                         uint32_t *ids) const
+{
+  switch (index.kind)
+  {
+  case ChildIndex::EMPTY:
+    break;
+  case ChildIndex::SINGLE:
+    keys[0] = index.key;
+    ids[0] = index.ref;
+    break;
+  case ChildIndex::N4:
+    memcpy(keys, this->pool4.blocks[index.ref].keys, index.count);
+    memcpy(ids, this->pool4.blocks[index.ref].ids,
+           index.count * sizeof(uint32_t));
+    break;
+  case ChildIndex::N16:
+    memcpy(keys, this->pool16.blocks[index.ref].keys, index.count);
+    memcpy(ids, this->pool16.blocks[index.ref].ids,
+           index.count * sizeof(uint32_t));
+    break;
+  case ChildIndex::N48:
+    memcpy(keys, this->pool48.blocks[index.ref].keys, index.count);
+    memcpy(ids, this->pool48.blocks[index.ref].ids,
+           index.count * sizeof(uint32_t));
+    break;
+  case ChildIndex::N256:
+  {
+    const Block256 &block = this->pool256.blocks[index.ref];
+    for (unsigned int i = 0; i < index.count; i++)
+    {
+      keys[i] = block.keys[i];
+      ids[i] = block.ids[block.keys[i]];
+    }
+    break;
+  }
+  }
+}
+
+// -----------------------------------------------------------------------------------------
+// Public functions
+// -----------------------------------------------------------------------------------------
+
+// --------------------------------------------------
+// Getters
+// --------------------------------------------------
+
+uint32_t ChildPools::find(const ChildIndex &index, unsigned char symbol) const
+{
+  switch (index.kind)
+  {
+  case ChildIndex::SINGLE:
+    return index.key == symbol ? index.ref : NO_CHILD;
+  case ChildIndex::N4:
+  {
+    const Block4 &block = this->pool4.blocks[index.ref];
+    for (unsigned int i = 0; i < index.count; i++)
+      if (block.keys[i] == symbol)
+        return block.ids[i];
+    return NO_CHILD;
+  }
+  case ChildIndex::N16:
+  {
+    const Block16 &block = this->pool16.blocks[index.ref];
+#if defined(__SSE2__)
+    // Compare all 16 keys at once
+    __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)symbol),
+                                 _mm_loadu_si128((const __m128i *)block.keys));
+    unsigned int mask =
+        _mm_movemask_epi8(cmp) & ((1U << index.count) - 1);
+    return mask ? block.ids[__builtin_ctz(mask)] : NO_CHILD;
+#else
+    for (unsigned int i = 0; i < index.count; i++)
+      if (block.keys[i] == symbol)
+        return block.ids[i];
+    return NO_CHILD;
+#endif
+  }
+  case ChildIndex::N48:
+  {
+    const Block48 &block = this->pool48.blocks[index.ref];
+    return block.slots[symbol] ? block.ids[block.slots[symbol] - 1]
+                               : NO_CHILD;
+  }
+  case ChildIndex::N256:
+    return this->pool256.blocks[index.ref].ids[symbol];
+  default:
+    return NO_CHILD;
+  }
+}
+
+uint32_t ChildPools::at(const ChildIndex &index, unsigned int i) const
+{
+  switch (index.kind)
+  {
+  case ChildIndex::SINGLE:
+    return index.ref;
+  case ChildIndex::N4:
+    return this->pool4.blocks[index.ref].ids[i];
+  case ChildIndex::N16:
+    return this->pool16.blocks[index.ref].ids[i];
+  case ChildIndex::N48:
+    return this->pool48.blocks[index.ref].ids[i];
+  case ChildIndex::N256:
+  {
+    const Block256 &block = this->pool256.blocks[index.ref];
+    return block.ids[block.keys[i]];
+  }
+  default:
+    return NO_CHILD;
+  }
+}
+
+// --------------------------------------------------
+// Setters
+// --------------------------------------------------
+
+void ChildPools::insert(ChildIndex &index, unsigned char symbol, uint32_t id)
+{
+  // Grow the layout if it is full
+  switch (index.kind)
+  {
+  case ChildIndex::EMPTY:
+    index.kind = ChildIndex::SINGLE;
+    index.key = symbol;
+    index.ref = id;
+    index.count = 1;
+    return;
+  case ChildIndex::SINGLE:
+    this->convert(index, ChildIndex::N4);
+    break;
+  case ChildIndex::N4:
+    if (index.count == 4)
+      this->convert(index, ChildIndex::N16);
+    break;
+  case ChildIndex::N16:
+    if (index.count == 16)
+      this->convert(index, ChildIndex::N48);
+    break;
+  case ChildIndex::N48:
+    if (index.count == 48)
+      this->convert(index, ChildIndex::N256);
+    break;
+  }
+
+  // Append the child
+  if (index.kind == ChildIndex::N4 || index.kind == ChildIndex::N16)
+  {
+    uint8_t *keys = index.kind == ChildIndex::N4
+                        ? this->pool4.blocks[index.ref].keys
+                        : this->pool16.blocks[index.ref].keys;
+    uint32_t *ids = index.kind == ChildIndex::N4
+                        ? this->pool4.blocks[index.ref].ids
+                        : this->pool16.blocks[index.ref].ids;
+    keys[index.count] = symbol;
+    ids[index.count] = id;
+  }
+  else if (index.kind == ChildIndex::N48)
+  {
+    Block48 &block = this->pool48.blocks[index.ref];
+    block.slots[symbol] = index.count + 1;
+    block.keys[index.count] = symbol;
+    block.ids[index.count] = id;
+  }
+  else
+  {
+    Block256 &block = this->pool256.blocks[index.ref];
+    block.ids[symbol] = id;
+    block.keys[index.count] = symbol;
+  }
+  index.count++;
+}
+
+void ChildPools::erase(ChildIndex &index, unsigned char symbol)
+{
+  // Ignore symbols without a child
+  if (this->find(index, symbol) == NO_CHILD)
+    return;
+
+  switch (index.kind)
+  {
+  case ChildIndex::SINGLE:
+    index = ChildIndex();
+    return;
+  case ChildIndex::N4:
+  case ChildIndex::N16:
+  {
+    uint8_t *keys = index.kind == ChildIndex::N4
+                        ? this->pool4.blocks[index.ref].keys
+                        : this->pool16.blocks[index.ref].keys;
+    uint32_t *ids = index.kind == ChildIndex::N4
+                        ? this->pool4.blocks[index.ref].ids
+                        : this->pool16.blocks[index.ref].ids;
+
+    // Close the gap
+    unsigned int pos = 0;
+    while (keys[pos] != symbol)
+      pos++;
+    memmove(keys + pos, keys + pos + 1, index.count - pos - 1);
+    memmove(ids + pos, ids + pos + 1,
+            (index.count - pos - 1) * sizeof(uint32_t));
+    index.count--;
+    break;
+  }
+  case ChildIndex::N48:
+  {
+    Block48 &block = this->pool48.blocks[index.ref];
+
+    // Close the gap and renumber the slots of the following children
+    unsigned int pos = block.slots[symbol] - 1;
+    memmove(block.keys + pos, block.keys + pos + 1, index.count - pos - 1);
+    memmove(block.ids + pos, block.ids + pos + 1,
+            (index.count - pos - 1) * sizeof(uint32_t));
+    index.count--;
+    for (; pos < index.count; pos++)
+      block.slots[block.keys[pos]] = pos + 1;
+    block.slots[symbol] = 0;
+    break;
+  }
+  case ChildIndex::N256:
+  {
+    Block256 &block = this->pool256.blocks[index.ref];
+
+    // Close the gap in the order of the keys
+    unsigned int pos = 0;
+    while (block.keys[pos] != symbol)
+      pos++;
+    memmove(block.keys + pos, block.keys + pos + 1, index.count - pos - 1);
+    block.ids[symbol] = NO_CHILD;
+    index.count--;
+    break;
+  }
+  }
+
+  // Shrink the layout (with some hysteresis to avoid thrashing)
+  if (index.kind == ChildIndex::N4 && index.count == 1)
+    this->convert(index, ChildIndex::SINGLE);
+  else if (index.kind == ChildIndex::N16 && index.count == 3)
+    this->convert(index, ChildIndex::N4);
+  else if (index.kind == ChildIndex::N48 && index.count == 12)
+    this->convert(index, ChildIndex::N16);
+  else if (index.kind == ChildIndex::N256 && index.count == 37)
+    this->convert(index, ChildIndex::N48);
+}
+
+void ChildPools::clear(ChildIndex &index)
+{
+  // Release the block of the layout
+  switch (index.kind)
+  {
+  case ChildIndex::N4:
+    this->pool4.release(index.ref);
+    break;
+  case ChildIndex::N16:
+    this->pool16.release(index.ref);
+    break;
+  case ChildIndex::N48:
+    this->pool48.release(index.ref);
+    break;
+  case ChildIndex::N256:
+    this->pool256.release(index.ref);
+    break;
+  }
+
+  index = ChildIndex();
+}
@@ -0,0 +1,219 @@
+#ifndef CHILD_INDEX_H
+#define CHILD_INDEX_H
+
+using namespace std;
+
+#include <cstdint>
+#include <vector>
+
+// ---------------------------------------------------------------------------------------------
+// Struct ChildIndex
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @struct ChildIndex
+ * @brief The (inline part of the) children of a Node, mapping a symbol to the
+ * id of the child representing it.
+ *
+ * Depending on the number of children the index uses a different layout
+ * (similar to an Adaptive Radix Tree): a single child is stored inline, up to
+ * 4 resp. 16 children are stored in key arrays, up to 48 children use a
+ * 256-entry slot table and more children use a direct 256-entry table. The
+ * blocks of the larger layouts are kept in ChildPools. Children are always
+ * iterated in the order they were added (as the children of a Node were
+ * before), so the ties of the dictionary selection do not depend on the
+ * layout.
+ */
+struct ChildIndex
+{
+  /**
+   * @brief The available layouts.
+   */
+  enum Kind : uint8_t
+  {
+    EMPTY,
+    SINGLE,
+    N4,
+    N16,
+    N48,
+    N256
+  };
+
+  /**
+   * @brief The current layout.
+   */
+  uint8_t kind;
+
+  /**
+   * @brief The symbol of the child if the layout is SINGLE.
+   */
+  uint8_t key;
+
+  /**
+   * @brief The number of children.
+   */
+  uint16_t count;
+
+  /**
+   * @brief The id of the child (SINGLE) or the index of the block in the pool
+   * of the layout (N4 - N256).
+   */
+  uint32_t ref;
+
+  /**
+   * @brief Constructs an empty index.
+   */
+  ChildIndex(void) : kind(EMPTY), key(0), count(0), ref(0) {}
+};
+
+// ---------------------------------------------------------------------------------------------
+// Class ChildPools
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @class ChildPools
+ * @brief Pools holding the blocks of all ChildIndexes of one arena and the
+ * operations on them.
+ */
+class ChildPools
+{
+public:
+  /**
+   * @brief The id returned if no child exists.
+   */
+  static constexpr uint32_t NO_CHILD = UINT32_MAX;
+
+private:
+  /**
+   * @brief Block of up to 4 children (in the order they were added).
+   */
+  struct Block4
+  {
+    uint8_t keys[4];
+    uint32_t ids[4];
+  };
+
+  /**
+   * @brief Block of up to 16 children (in the order they were added).
+   */
+  struct Block16
+  {
+    uint8_t keys[16];
+    uint32_t ids[16];
+  };
+
+  /**
+   * @brief Block of up to 48 children (in the order they were added).
+   * slots[key] is the position of the child in ids (+1, 0 = no child), keys is
+   * the reverse mapping.
+   */
+  struct Block48
+  {
+    uint8_t slots[256];
+    uint8_t keys[48];
+    uint32_t ids[48];
+  };
+
+  /**
+   * @brief Block of up to 256 children indexed directly by their key. keys
+   * holds the keys in the order they were added.
+   */
+  struct Block256
+  {
+    uint32_t ids[256];
+    uint8_t keys[256];
+  };
+
+  /**
+   * @brief A pool of blocks of one layout with a free list.
+   */
+  template <typename T>
+  struct Pool
+  {
+    std::vector<T> blocks;
+    std::vector<uint32_t> free_blocks;
+
+    uint32_t allocate()
+    {
+      if (!free_blocks.empty())
+      {
+        uint32_t i = free_blocks.back();
+        free_blocks.pop_back();
+        return i;
+      }
+      blocks.emplace_back();
+      return blocks.size() - 1;
+    }
+
+    void release(uint32_t i) { free_blocks.push_back(i); }
+  };
+
+  Pool<Block4> pool4;
+  Pool<Block16> pool16;
+  Pool<Block48> pool48;
+  Pool<Block256> pool256;
+
+  /**
+   * @brief Converts an index to another layout (keeping all children).
+   * @param index The index to convert.
+   * @param kind The new layout.
+   */
+  void convert(ChildIndex &index, uint8_t kind);
+
+  /**
+   * @brief Copies the keys and ids of all children (in the order they were
+   * added).
+   * @param index The index.
+   * @param keys The array to write the keys to.
+   * @param ids The array to write the ids to.
+   */
+  void collect(const ChildIndex &index, uint8_t *keys, uint32_t *ids) const;
+
+public:
+  // --------------------------------------------------
+  // Getters
+  // --------------------------------------------------
+
+  /**
+   * @brief Gets the id of the child with the given symbol.
+   * @param index The index to search in.
+   * @param symbol The symbol of the child.
+   * @return The id of the child or NO_CHILD.
+   */
+  uint32_t find(const ChildIndex &index, unsigned char symbol) const;
+
+  /**
+   * @brief Gets the id of the i-th child (in the order they were added).
+   * @param index The index.
+   * @param i The position of the child.
+   * @return The id of the child.
+   */
+  uint32_t at(const ChildIndex &index, unsigned int i) const;
+
+  // --------------------------------------------------
+  // Setters
+  // --------------------------------------------------
+
+  /**
+   * @brief Adds a child (the symbol must not be present yet).
+   * @param index The index to add to.
+   * @param symbol The symbol of the child.
+   * @param id The id of the child.
+   */
+  void insert(ChildIndex &index, unsigned char symbol, uint32_t id);
+
+  /**
+   * @brief Removes a child (if present), keeping the order of the others.
+   * @param index The index to remove from.
+   * @param symbol The symbol of the child.
+   */
+  void erase(ChildIndex &index, unsigned char symbol);
+
+  /**
+   * @brief Removes all children and releases the block of the index.
+   * @param index The index to clear.
+   */
+  void clear(ChildIndex &index);
+};
+
+#endif
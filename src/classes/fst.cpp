@@ -2,13 +2,19 @@ using namespace std;
 
 #include "fst.h"
 #include "../helpers/string_helpers.h"
+#include "fst_snapshot.h"
 #include "node.h"
+#include <algorithm>
 #include <cstring>
+#include <exception>
 #include <iostream>
 #include <list>
+#include <numeric>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 // ---------------------------------------------------------------------------------------------
 // Class FST
@@ -25,84 +31,178 @@ using namespace std;
 void FST::addPath(Node *node)
 {
   // Add a new path
-  this->paths.push_back(node);
+  this->paths.push_back(node->getId());
+
+  // Register the path in the root table
+  this->roots[(unsigned char)node->getSymbol()] = node->getId();
 }
 
 void FST::removePath(Node *node)
 {
   // Remove a child from the FST
+  uint32_t id = node->getId();
   for (unsigned int i = 0; i < this->paths.size(); i++)
-    if (this->paths.at(i) == node)
+    if (this->paths.at(i) == id)
       this->paths.erase(this->paths.begin() + i);
+  this->roots[(unsigned char)node->getSymbol()] = NodeArena::NO_NODE;
 
-  // Delete the Node
-  delete (node);
+  // Release the Node (and its subtree) back to the arena
+  this->arena.releaseSubtree(id);
 }
 
 // --------------------------------------------------
 // Adders
 // --------------------------------------------------
 
-void FST::addSubstring(char *substring, unsigned int length)
+void FST::addSubstring(const char *string, unsigned int begin,
+                       unsigned int length, unsigned int weight)
 {
   // Check if there is a node for the first character of the substring
-  Node *root_node = this->getPath(substring[0]);
+  Node *node = this->getPath(string[begin]);
 
   // If there is no node for the first character of the substring, create one
-  if (root_node == NULL)
+  if (node == NULL)
   {
-    root_node = new Node(substring[0], 0, 0, NULL);
-    this->addPath(root_node);
+    node = this->arena.createNode(string[begin], 0, 0, NULL);
+    this->addPath(node);
   }
 
-  // Call the addSubstring function of the root node
-  root_node->addSubstring(substring, length);
-}
+  // Follow (and extend) the path of the substring
+  for (unsigned int level = 0;; level++)
+  {
+    // Raise the frequency of the node (once per copy of the string)
+    node->raiseFrequency(weight);
 
-void FST::addOverlaps(string string)
-{
-  // Get the symbols contained in the string
-  set<char> symbols = string_helpers::get_contained_chars(string);
+    // Count the occurrence, it cannot be replaced if it overlaps the last
+    // replaceable occurrence of the node within the string (in every copy)
+    if (this->arena.countOccurrence(node, begin, begin + level + 1))
+      node->raiseOverlaps(weight);
 
-  // For each symbol
-  for (set<char>::iterator it = symbols.begin(); it != symbols.end(); it++)
-  {
-    // Get the root node of the path with the symbol
-    Node *root_node = this->getPath(*it);
+    // Stop at the end of the substring
+    if (level + 1 == length)
+      break;
 
-    // If there is a root node for the symbol
-    if (root_node != NULL)
+    // Get the child for the next character (creating it if necessary)
+    char symbol = string[begin + level + 1];
+    Node *child = node->getChild(symbol);
+    if (child == NULL)
     {
-      // Call the addOverlaps function of the root node
-      root_node->addOverlaps(string);
+      child = this->arena.createNode(symbol, 0, level + 1, node);
+      node->addChild(child);
     }
+    node = child;
   }
 }
 
+void FST::orderCreatedNodes(vector<uint64_t> &first_occurrences)
+{
+  // The nodes that existed before keep their order (the sorts are stable)
+  first_occurrences.resize(this->arena.getCapacity(), 0);
+  auto earlier = [&](uint32_t a, uint32_t b)
+  { return first_occurrences[a] < first_occurrences[b]; };
+  stable_sort(this->paths.begin(), this->paths.end(), earlier);
+
+  // Reorder the children of every node that got a new child
+  vector<uint32_t> ids;
+  vector<Node *> children;
+  this->visit(
+      [&](Node *node, string_view)
+      {
+        ids.clear();
+        bool created = false;
+        for (unsigned int i = 0; i < node->getNrChildren(); i++)
+        {
+          ids.push_back(node->getChild(i)->getId());
+          created |= first_occurrences[ids.back()] != 0;
+        }
+        if (created && ids.size() > 1)
+        {
+          stable_sort(ids.begin(), ids.end(), earlier);
+          children.clear();
+          for (uint32_t id : ids)
+            children.push_back(this->arena.getNode(id));
+          node->reorderChildren(children);
+        }
+        return true;
+      });
+}
+
 // --------------------------------------------------
 // Subtractors
 // --------------------------------------------------
 
-void FST::subtractOverlaps(string string)
+void FST::subtractOverlaps(string_view str, unsigned int count)
 {
-  // Get the symbols contained in the string
-  set<char> symbols = string_helpers::get_contained_chars(string);
+  // Count the occurrences of the substrings in a new string
+  this->arena.beginOccurrences();
 
-  // For each symbol
-  for (set<char>::iterator it = symbols.begin(); it != symbols.end(); it++)
+  // Follow every suffix of the string through the FST (from left to right, so
+  // the occurrences of every node are counted in order)
+  for (unsigned int begin = 0; begin < str.length(); begin++)
   {
-    // Get the root node of the path with the symbol
-    Node *root_node = this->getPath(*it);
-
-    // If there is a root node for the symbol
-    if (root_node != NULL)
+    Node *node = this->getPath(str[begin]);
+    unsigned int end = begin + 1;
+    while (node != NULL)
     {
-      // Call the subtractOverlaps function of the root node
-      root_node->subtractOverlaps(string);
+      // Occurrences overlapping the last replaceable one were counted as
+      // overlaps
+      if (this->arena.countOccurrence(node, begin, end))
+        node->lowerOverlaps(count);
+
+      if (end == str.length())
+        break;
+      node = node->getChild(str[end++]);
     }
   }
 }
 
+// --------------------------------------------------
+// Gain selection
+// --------------------------------------------------
+
+GainHeap FST::getGainHeap(unsigned int max_level) const
+{
+  GainHeap heap(this->arena.getCapacity());
+
+  // Rank the nodes in pre-order (paths and children in the order they were
+  // added), which is the order the stable sort of getSortedGainList starts
+  // from
+  uint32_t rank = 0;
+  this->visit(
+      [&](Node *node, string_view)
+      {
+        // Add all non-root nodes to the heap
+        if (node->getLevel() > 0)
+          heap.push(node->getId(), this->gain_model->getNetGain(node), rank++);
+        return true;
+      },
+      max_level);
+
+  return heap;
+}
+
+void FST::updateGainHeap(GainHeap &heap, unsigned int max_level)
+{
+  // New nodes have no rank yet, so the heap has to be rebuilt
+  if (this->arena.haveNodesBeenCreated())
+  {
+    heap = this->getGainHeap(max_level);
+    this->arena.clearChanges();
+    return;
+  }
+
+  // Remove the released nodes
+  for (uint32_t id : this->arena.getReleasedIds())
+    heap.remove(id);
+
+  // Update the gain of the changed nodes that are still candidates
+  for (uint32_t id : this->arena.getChangedIds())
+    if (heap.contains(id))
+      heap.update(id, this->gain_model->getNetGain(this->arena.getNode(id)));
+
+  this->arena.clearChanges();
+}
+
 // -----------------------------------------------------------------------------------------
 // Public functions
 // -----------------------------------------------------------------------------------------
@@ -111,13 +211,28 @@ void FST::subtractOverlaps(string string)
 // Constructor and destructor
 // --------------------------------------------------
 
-FST::FST() {}
+FST::FST(unsigned int max_depth)
+    : max_depth(max_depth), suffixes_truncated(false),
+      gain_model(&GainModel::getDefault())
+{
+  // There are no paths yet
+  for (unsigned int i = 0; i < 256; i++)
+    this->roots[i] = NodeArena::NO_NODE;
+}
 
 FST::~FST()
 {
-  // Delete all paths
-  for (unsigned int i = 0; i < this->paths.size(); i++)
-    delete (this->paths.at(i));
+  // All paths are freed at once together with the arena
+}
+
+// --------------------------------------------------
+// Setters
+// --------------------------------------------------
+
+void FST::setGainModel(const GainModel *gain_model)
+{
+  // Set the gain model (or go back to the default one)
+  this->gain_model = gain_model != NULL ? gain_model : &GainModel::getDefault();
 }
 
 // --------------------------------------------------
@@ -130,24 +245,37 @@ unsigned int FST::getNrPaths() const
   return this->paths.size();
 }
 
+unsigned int FST::getMaxDepth() const
+{
+  // Get the maximum level of the nodes
+  return this->max_depth;
+}
+
+const GainModel *FST::getGainModel() const
+{
+  // Get the model defining the gain of the nodes
+  return this->gain_model;
+}
+
 Node *FST::getPath(unsigned int i) const
 {
   // Get the i-th path
-  return this->paths.at(i);
+  return this->arena.getNode(this->paths.at(i));
 }
 
 Node *FST::getPath(const char &symbol) const
 {
-  // Search through all paths and return the one with the given symbol
-  for (unsigned int j = 0; j < this->paths.size(); j++)
-    if (this->paths.at(j)->getSymbol() == symbol)
-      return this->paths.at(j);
+  // Look up the path with the given symbol in the root table
+  uint32_t id = this->roots[(unsigned char)symbol];
 
   // If no path with the given symbol was found, return NULL
-  return NULL;
+  if (id == NodeArena::NO_NODE)
+    return NULL;
+
+  return this->arena.getNode(id);
 }
 
-Node *FST::getNodeRepresentingSubstring(string substring) const
+Node *FST::getNodeRepresentingSubstring(string_view substring) const
 {
   // Check if there is a Node for the first character of the substring
   Node *root_node = this->getPath(substring[0]);
@@ -165,14 +293,18 @@ list<Node *> FST::getSortedGainList(unsigned int max_level) const
   // Create a list of all Nodes
   list<Node *> nodes;
 
-  // For all paths get the descendents and add them to the list
-  for (unsigned int i = 0; i < this->getNrPaths(); i++)
-  {
-    nodes.splice(nodes.end(), this->getPath(i)->getDescendants(max_level));
-  }
+  // Add the non-root nodes of all paths to the list (in pre-order)
+  this->visit(
+      [&](Node *node, string_view)
+      {
+        if (node->getLevel() > 0)
+          nodes.push_back(node);
+        return true;
+      },
+      max_level);
 
   // Sort the list
-  nodes.sort(NodeCompare());
+  nodes.sort(NodeCompare(this->gain_model));
 
   // Return the sorted list
   return nodes;
@@ -183,32 +315,54 @@ list<Node *> FST::getSortedGainList(unsigned int max_level) const
 // --------------------------------------------------
 
 list<string> FST::getDictionaryEntries(unsigned int x,
-                                       unsigned int max_level)
+                                       unsigned int max_level,
+                                       vector<unsigned int> *occurrences)
 {
   // Save the dictionary entries in a list of strings
   list<string> dict_entries;
 
-  // Find x dictionary entries
-  for (unsigned int i = 0; i < x; i++)
-  {
-    // Get the sorted gain list
-    list<Node *> sorted_gain_list = this->getSortedGainList(max_level);
+  // Build the heap of all candidates once and only update it for the nodes
+  // that change (this selects the same nodes as getSortedGainList().front())
+  GainHeap heap = this->getGainHeap(max_level);
+  this->arena.setTracking(true);
 
-    // If the sorted gain list is empty, break the loop
-    if (sorted_gain_list.size() < 1)
+  try
+  {
+    // Find x dictionary entries
+    for (unsigned int i = 0; i < x; i++)
     {
-      break;
+      // If there are no candidates (worth adding) left, break the loop
+      if (heap.isEmpty() ||
+          heap.getGain(heap.getTop()) < this->gain_model->getMinimumGain())
+      {
+        break;
+      }
+
+      // Get the node with the highest gain
+      Node *highest_gain_node = this->arena.getNode(heap.getTop());
+
+      // Add the highest gain node to the dictionary
+      dict_entries.push_back(highest_gain_node->getSubstring());
+      if (occurrences != NULL)
+        occurrences->push_back(highest_gain_node->getFrequency() -
+                               highest_gain_node->getOverlaps());
+
+      // Remove the highest gain node from the FST
+      this->handleSubstringAddedToDict(highest_gain_node);
+
+      // Update the heap with the nodes that changed
+      this->updateGainHeap(heap, max_level);
     }
-
-    // Get the node with the highest gain
-    Node *highest_gain_node = sorted_gain_list.front();
-
-    // Add the highest gain node to the dictionary
-    dict_entries.push_back(highest_gain_node->getSubstring());
-
-    // Remove the highest gain node from the FST
-    this->handleSubstringAddedToDict(highest_gain_node);
   }
+  catch (...)
+  {
+    // Stop recording changes before passing on the error
+    this->arena.setTracking(false);
+    throw;
+  }
+
+  this->arena.setTracking(false);
+  this->arena.releaseOccurrences();
 
   // Return the list of dictionary entries
   return dict_entries;
@@ -218,7 +372,7 @@ list<string> FST::getDictionaryEntries(unsigned int x,
 // Remove substring from the FST
 // --------------------------------------------------
 
-void FST::subtractSubstring(string substring)
+void FST::subtractSubstring(string_view substring, unsigned int count)
 {
   // Check if there is a Node for the first character of the substring
   Node *root_node = this->getPath(substring[0]);
@@ -227,7 +381,16 @@ void FST::subtractSubstring(string substring)
   // removeSubstring function of the root Node
   if (root_node != NULL)
   {
-    root_node->subtractSubstring(substring);
+    root_node->subtractSubstring(substring, count);
+
+    // If suffixes have been cut at the maximum depth, the occurrence may have
+    // been inserted deeper than the subtracted substring reaches
+    if (this->suffixes_truncated)
+    {
+      Node *node = root_node->getNodeRepresentingSubstring(substring);
+      if (node != NULL)
+        node->trimChildren();
+    }
 
     // If the root node has a frequency of 0, remove it
     if (root_node->getFrequency() == 0)
@@ -238,7 +401,7 @@ void FST::subtractSubstring(string substring)
     // Throw an exception
     throw runtime_error(
         "FST::subtractSubstring: No path for substring " +
-        substring);
+        string(substring));
   }
 }
 
@@ -246,49 +409,413 @@ void FST::subtractSubstring(string substring)
 // Add string to the FST
 // --------------------------------------------------
 
-void FST::addString(char *string, unsigned int length)
+void FST::addString(const char *string, unsigned int length,
+                    unsigned int weight)
 {
-  // For each character in the string create a substring (starting the the i-th
-  // character)
+  // The overlaps are counted while the suffixes are added
+  this->arena.beginOccurrences();
+
+  // For each character in the string add the suffix starting at the i-th
+  // character (in place, without copying it)
   for (unsigned int i = 0; i < length; i++)
   {
-    // Create a substring starting with the i-th character
-    char *chars_to_add = new char[length - i];
-    strncpy(chars_to_add, (string + i), length - i);
+    // Only insert the suffix up to the maximum depth
+    unsigned int suffix_length = length - i;
+    if (this->max_depth != UNLIMITED_DEPTH &&
+        suffix_length > this->max_depth + 1)
+    {
+      suffix_length = this->max_depth + 1;
+      this->suffixes_truncated = true;
+    }
 
-    // Add the substring to the FST
-    this->addSubstring(chars_to_add, length - i);
+    // Add the suffix to the FST
+    this->addSubstring(string, i, suffix_length, weight);
   }
+}
 
-  // Add overlaps
-  this->addOverlaps(string);
+void FST::addString(string_view str, unsigned int weight)
+{
+  // Add the string to the FST
+  this->addString(str.data(), str.length(), weight);
 }
 
-void FST::addString(string str)
+// --------------------------------------------------
+// Remove string from the FST
+// --------------------------------------------------
+
+void FST::removeString(const char *string, unsigned int length,
+                       unsigned int weight)
 {
-  // Convert the string to a char array
-  char *string = new char[str.length() + 1];
-  strcpy(string, str.c_str());
+  // Get the length of the suffix starting at the i-th character as it was
+  // inserted by addString
+  auto suffix_length = [&](unsigned int i)
+  {
+    unsigned int suffix_length = length - i;
+    if (this->max_depth != UNLIMITED_DEPTH &&
+        suffix_length > this->max_depth + 1)
+      suffix_length = this->max_depth + 1;
+    return suffix_length;
+  };
+
+  // Check that every suffix is part of the FST before changing anything
+  for (unsigned int i = 0; i < length; i++)
+    if (this->getNodeRepresentingSubstring(
+            string_view(string + i, suffix_length(i))) == NULL)
+      throw runtime_error("FST::removeString: The string " +
+                          std::string(string, length) +
+                          " is not part of the FST");
+
+  // Subtract the overlaps first (they are counted along the nodes of the
+  // suffixes, which may be removed afterwards)
+  this->subtractOverlaps(string_view(string, length), weight);
+
+  // Subtract every suffix (without trimming deeper nodes, the suffixes were
+  // inserted up to the maximum depth)
+  for (unsigned int i = 0; i < length; i++)
+  {
+    Node *root_node = this->getPath(string[i]);
+    root_node->subtractSubstring(string_view(string + i, suffix_length(i)),
+                                 weight);
 
-  // Add the string to the FST
-  this->addString(string, str.length());
+    // If the root node has a frequency of 0, remove it
+    if (root_node->getFrequency() == 0)
+      this->removePath(root_node);
+  }
+}
 
-  // Delete the char array
-  delete (string);
+void FST::removeString(string_view str, unsigned int weight)
+{
+  // Remove the string from the FST
+  this->removeString(str.data(), str.length(), weight);
 }
 
 // --------------------------------------------------
 // Add a list of strings to the FST
 // --------------------------------------------------
 
-void FST::addStrings(list<string> strings)
+void FST::addStrings(const list<string> &strings)
 {
   // For each string in the list
-  for (list<string>::iterator it = strings.begin(); it != strings.end(); it++)
+  for (list<string>::const_iterator it = strings.begin(); it != strings.end();
+       it++)
   {
     // Add the string to the FST
     this->addString(*it);
   }
+
+  // The occurrences are only counted while strings are added
+  this->arena.releaseOccurrences();
+}
+
+void FST::addStringsInParallel(const vector<string_view> &strings,
+                               unsigned int nr_threads,
+                               const vector<unsigned int> &weights)
+{
+  // Get the number of threads worth using
+  if (nr_threads == 0)
+    nr_threads = max(1U, thread::hardware_concurrency());
+  nr_threads = min<size_t>(nr_threads, strings.size() / MIN_STRINGS_PER_SHARD);
+
+  // Small inputs are added directly
+  if (nr_threads <= 1)
+  {
+    for (size_t i = 0; i < strings.size(); i++)
+      this->addString(strings[i], weights.empty() ? 1 : weights[i]);
+    this->arena.releaseOccurrences();
+    return;
+  }
+
+  // Build a partial FST over each shard of the strings
+  vector<FST *> shards(nr_threads);
+  vector<exception_ptr> errors(nr_threads);
+  vector<thread> workers;
+  for (unsigned int t = 0; t < nr_threads; t++)
+  {
+    shards[t] = new FST(this->max_depth);
+    size_t begin = strings.size() * t / nr_threads;
+    size_t end = strings.size() * (t + 1) / nr_threads;
+
+    workers.emplace_back([&strings, &weights, &shards, &errors, t, begin,
+                          end]() {
+      try
+      {
+        for (size_t i = begin; i < end; i++)
+          shards[t]->addString(strings[i], weights.empty() ? 1 : weights[i]);
+        shards[t]->arena.releaseOccurrences();
+      }
+      catch (...)
+      {
+        errors[t] = current_exception();
+      }
+    });
+  }
+
+  // Wait for all threads
+  for (thread &worker : workers)
+    worker.join();
+
+  // Merge the partial FSTs into this one
+  exception_ptr error = NULL;
+  for (unsigned int t = 0; t < nr_threads; t++)
+  {
+    if (errors[t] != NULL && error == NULL)
+      error = errors[t];
+    if (error == NULL)
+      this->merge(*shards[t]);
+    delete shards[t];
+  }
+
+  // Pass on the first error of a thread
+  if (error != NULL)
+    rethrow_exception(error);
+}
+
+void FST::addStringsWithSuffixArray(const vector<string_view> &strings,
+                                    const vector<unsigned int> &weights)
+{
+  // Sort all suffixes (truncated to the deepest level that is kept)
+  SuffixArray suffix_array(strings,
+                           this->max_depth == UNLIMITED_DEPTH
+                               ? UINT_MAX
+                               : this->max_depth + 1,
+                           weights);
+  unsigned int nr_suffixes = suffix_array.getNrSuffixes();
+  for (string_view str : strings)
+    if (this->max_depth != UNLIMITED_DEPTH && str.length() > this->max_depth + 1)
+      this->suffixes_truncated = true;
+
+  // The nodes the current suffix passes through (one per level), the rank of
+  // the first suffix passing through each, the number of suffixes ending in
+  // each subtree so far and the first position of the substring of each (if
+  // the node was created here)
+  vector<Node *> path;
+  vector<unsigned int> first_ranks;
+  vector<unsigned int> counts;
+  vector<uint64_t> firsts;
+  vector<uint64_t> first_occurrences;
+
+  for (unsigned int i = 0; i <= nr_suffixes; i++)
+  {
+    // Close the nodes the suffix does not pass through anymore
+    unsigned int lcp = i < nr_suffixes ? suffix_array.getLcp(i) : 0;
+    while (path.size() > lcp)
+    {
+      Node *node = path.back();
+      unsigned int count = counts.back();
+      node->raiseFrequency(count);
+      node->raiseOverlaps(suffix_array.getNrOverlaps(first_ranks.back(), i,
+                                                     path.size()));
+      uint64_t first = firsts.back();
+      if (first_occurrences.size() > node->getId() &&
+          first_occurrences[node->getId()] != 0)
+        first_occurrences[node->getId()] = first + 1;
+      path.pop_back();
+      first_ranks.pop_back();
+      counts.pop_back();
+      firsts.pop_back();
+
+      // The suffixes of the subtree also pass through the parent
+      if (!counts.empty())
+      {
+        counts.back() += count;
+        firsts.back() = min(firsts.back(), first);
+      }
+    }
+
+    // Skip the empty suffixes (they all come first)
+    if (i == nr_suffixes || suffix_array.getLength(i) == 0)
+      continue;
+
+    // Open the nodes for the rest of the suffix (creating the missing ones)
+    int pos = suffix_array.getPosition(i);
+    while (path.size() < suffix_array.getLength(i))
+    {
+      char symbol = suffix_array.getSymbol(pos + path.size());
+      Node *node = path.empty() ? this->getPath(symbol)
+                                : path.back()->getChild(symbol);
+      if (node == NULL)
+      {
+        if (path.empty())
+        {
+          node = this->arena.createNode(symbol, 0, 0, NULL);
+          this->addPath(node);
+        }
+        else
+        {
+          node = this->arena.createNode(symbol, 0, path.size(), path.back());
+          path.back()->addChild(node);
+        }
+
+        // Mark the node as created (its first position is set on closing)
+        if (first_occurrences.size() <= node->getId())
+          first_occurrences.resize(this->arena.getCapacity(), 0);
+        first_occurrences[node->getId()] = 1;
+      }
+
+      path.push_back(node);
+      first_ranks.push_back(i);
+      counts.push_back(0);
+      firsts.push_back(UINT64_MAX);
+    }
+
+    // The suffix ends in the deepest node (once per copy of its string)
+    counts.back() += suffix_array.getWeight(pos);
+    firsts.back() = min<uint64_t>(firsts.back(), pos);
+  }
+
+  // The suffixes were added in sorted order, addString creates the nodes in
+  // the order of their first occurrence
+  this->orderCreatedNodes(first_occurrences);
+}
+
+void FST::addHeavyHitters(const SpaceSaving &counter)
+{
+  // The counts of a long stream may exceed the frequencies of the nodes
+  auto clamp = [](uint64_t count)
+  { return (unsigned int)min<uint64_t>(count, UINT_MAX); };
+
+  // The heavy hitters are windows of the strings, not their suffixes
+  if (this->max_depth != UNLIMITED_DEPTH)
+    this->suffixes_truncated = true;
+
+  // The first position of the substring of every created node (+ 1)
+  vector<uint64_t> first_occurrences;
+  auto created = [&](Node *node, uint64_t first_position)
+  {
+    if (first_occurrences.size() <= node->getId())
+      first_occurrences.resize(this->arena.getCapacity(), 0);
+    first_occurrences[node->getId()] = first_position + 1;
+  };
+
+  // Every byte is a path with its exact frequency
+  for (unsigned int byte = 0; byte < 256; byte++)
+  {
+    if (counter.getByteFrequency(byte) == 0)
+      continue;
+
+    Node *node = this->getPath((char)byte);
+    if (node == NULL)
+    {
+      node = this->arena.createNode((char)byte, 0, 0, NULL);
+      this->addPath(node);
+      created(node, counter.getByteFirstPosition(byte));
+    }
+    node->raiseFrequency(clamp(counter.getByteFrequency(byte)));
+  }
+
+  // Every kept substring is a node (creating the prefixes that were not kept)
+  for (const SpaceSaving::HeavyHitter &heavy_hitter :
+       counter.getHeavyHitters())
+  {
+    const string &substring = heavy_hitter.substring;
+    if (this->max_depth != UNLIMITED_DEPTH &&
+        substring.length() > this->max_depth + 1)
+      continue;
+
+    Node *node = this->getPath(substring[0]);
+    for (unsigned int level = 1; level < substring.length(); level++)
+    {
+      Node *child = node->getChild(substring[level]);
+      if (child == NULL)
+      {
+        child = this->arena.createNode(substring[level], 0, level, node);
+        node->addChild(child);
+        created(child, heavy_hitter.first_position);
+      }
+      // A prefix occurs first at the latest with the first kept substring
+      else if (first_occurrences.size() > child->getId() &&
+               first_occurrences[child->getId()] >
+                   heavy_hitter.first_position + 1)
+        first_occurrences[child->getId()] = heavy_hitter.first_position + 1;
+      node = child;
+    }
+    node->raiseFrequency(clamp(heavy_hitter.frequency));
+    node->raiseOverlaps(clamp(heavy_hitter.overlaps));
+  }
+
+  // The heavy hitters are added by frequency, addString creates the nodes in
+  // the order of their first occurrence
+  this->orderCreatedNodes(first_occurrences);
+
+  // A node occurs at least as often as its children together
+  this->traverse([](Node *, string_view) { return true; },
+                 [&](Node *node, string_view)
+                 {
+                   uint64_t children_frequency = 0;
+                   for (unsigned int i = 0; i < node->getNrChildren(); i++)
+                     children_frequency += node->getChild(i)->getFrequency();
+                   if (children_frequency > node->getFrequency())
+                     node->raiseFrequency(clamp(children_frequency) -
+                                          node->getFrequency());
+                 });
+}
+
+void FST::addStrings(const vector<string_view> &strings,
+                     CountingBackend backend, unsigned int nr_threads)
+{
+  // Count the substrings with the chosen backend
+  if (backend == SPACE_SAVING)
+    this->addStrings(strings, vector<unsigned int>(strings.size(), 1), backend);
+  else if (backend == SUFFIX_ARRAY)
+    this->addStringsWithSuffixArray(strings);
+  else
+    this->addStringsInParallel(strings, nr_threads);
+}
+
+void FST::addStrings(const vector<string_view> &strings,
+                     const vector<unsigned int> &weights,
+                     CountingBackend backend, unsigned int nr_threads)
+{
+  // Every string needs a weight (of at least one)
+  if (weights.size() != strings.size())
+    throw invalid_argument(
+        "FST::addStrings: The number of weights differs from the number of "
+        "strings");
+  if (find(weights.begin(), weights.end(), 0U) != weights.end())
+    throw invalid_argument("FST::addStrings: A string has a weight of zero");
+
+  // Count the substrings with the chosen backend
+  if (backend == SPACE_SAVING)
+  {
+    // Count the substrings up to the maximum depth (at least the pairs)
+    unsigned int max_length = SpaceSaving::MAX_LENGTH;
+    if (this->max_depth < max_length)
+      max_length = max(2U, this->max_depth + 1);
+
+    SpaceSaving counter(SPACE_SAVING_CAPACITY, 2, max_length);
+    for (size_t i = 0; i < strings.size(); i++)
+      counter.addString(strings[i], weights[i]);
+    this->addHeavyHitters(counter);
+  }
+  else if (backend == SUFFIX_ARRAY)
+    this->addStringsWithSuffixArray(strings, weights);
+  else
+    this->addStringsInParallel(strings, nr_threads, weights);
+}
+
+// --------------------------------------------------
+// Merge FSTs
+// --------------------------------------------------
+
+void FST::merge(const FST &fst)
+{
+  // Both FSTs have to contain the same substrings
+  if (fst.max_depth != this->max_depth)
+    throw invalid_argument("FST::merge: The maximum depths of the FSTs differ");
+  this->suffixes_truncated |= fst.suffixes_truncated;
+
+  // Merge the paths (creating the missing ones)
+  for (unsigned int i = 0; i < fst.getNrPaths(); i++)
+  {
+    Node *path = fst.getPath(i);
+    Node *root_node = this->getPath(path->getSymbol());
+    if (root_node == NULL)
+    {
+      root_node = this->arena.createNode(path->getSymbol(), 0, 0, NULL);
+      this->addPath(root_node);
+    }
+    root_node->merge(path);
+  }
 }
 
 // --------------------------------------------------
@@ -299,10 +826,10 @@ void FST::addStrings(list<string> strings)
 void FST::deleteFullStringOccurrences(string substring)
 {
   // For all paths in the FST
-  for (Node *path : this->paths)
+  for (uint32_t id : this->paths)
   {
     // Call the deleteFullStringOccurrences function of the path
-    path->deleteFullStringOccurrences(substring);
+    this->arena.getNode(id)->deleteFullStringOccurrences(substring);
   }
 
   // Remove all paths with a frequency of 0
@@ -329,35 +856,58 @@ void FST::handleSubstringAddedToDict(Node *node)
   string substring = node->getSubstring();
 
   // Get the represented substrings of the node (so all substrings starting with
-  // "substring" but potentially longer)
-  list<string> substrings = node->getRepresentedSubstrings();
-
-  // Get the original strings by removing contained substrings
-  list<string> original_strings =
-      string_helpers::delete_contained_substrings(substrings);
-
-  // For all original_strings in the list subtract the overlaps
-  for (string original_string : original_strings)
-  {
-    // Subtract the overlaps
-    this->subtractOverlaps(original_string);
-  }
-
-  // Get all substrings that need to be deleted
-  list<string> substrings_to_delete =
-      string_helpers::get_substrings_to_delete(substring, original_strings);
+  // "substring" but potentially longer), each with its number of copies
+  string buffer;
+  vector<pair<string_view, unsigned int>> substrings =
+      node->getRepresentedSubstringCounts(buffer);
+
+  // Get the original strings by removing contained substrings. If suffixes
+  // have been cut at the maximum depth, every represented substring is a
+  // window starting at exactly one occurrence instead of the tail of an
+  // original string, so the windows are used as they are.
+  bool capped = this->suffixes_truncated;
+  vector<pair<string_view, unsigned int>> original_strings =
+      capped ? substrings
+             : string_helpers::delete_contained_substrings(substrings);
+
+  // For all original_strings in the list subtract the overlaps (of all copies
+  // at once)
+  for (const pair<string_view, unsigned int> &original_string :
+       original_strings)
+    this->subtractOverlaps(original_string.first, original_string.second);
+
+  // Get all substrings that need to be deleted (for windows only the occurrence
+  // they start with, the others have their own windows)
+  vector<pair<string_view, unsigned int>> substrings_to_delete =
+      capped ? original_strings
+             : string_helpers::get_substrings_to_delete(substring,
+                                                        original_strings);
 
   // For all substrings_to_delete substract the substring
-  for (string substring_to_delete : substrings_to_delete)
+  for (const pair<string_view, unsigned int> &substring_to_delete :
+       substrings_to_delete)
   {
     // For each character in the modified represented substring subtract the
     // corresponding subsubstring (starting the the i-th character) However, do
     // not subtract more than the length of the substring itself
-    for (unsigned int i = 1;
-         i < min(substring_to_delete.length(), substring.length()); i++)
+    string_view str = substring_to_delete.first;
+    unsigned int copies = substring_to_delete.second;
+    if (!capped)
     {
-      // Subtract the substring_to_delete starting with the i-th character
-      this->subtractSubstring(substring_to_delete.substr(i));
+      // Subtract all copies at once
+      for (unsigned int i = 1; i < min(str.length(), substring.length()); i++)
+        this->subtractSubstring(str.substr(i), copies);
+    }
+    else
+    {
+      // Windows of overlapping occurrences may share suffixes that are already
+      // subtracted (and subtracting trims the children), so the copies are
+      // subtracted one by one
+      for (unsigned int copy = 0; copy < copies; copy++)
+        for (unsigned int i = 1; i < min(str.length(), substring.length());
+             i++)
+          if (this->getNodeRepresentingSubstring(str.substr(i)) != NULL)
+            this->subtractSubstring(str.substr(i));
     }
   }
 
@@ -365,6 +915,137 @@ void FST::handleSubstringAddedToDict(Node *node)
   this->deleteFullStringOccurrences(substring);
 }
 
+// --------------------------------------------------
+// Snapshots
+// --------------------------------------------------
+
+void FST::save(const string &path) const
+{
+  // Append siblings ordered by their unsigned symbol, remembering the
+  // position they have in the FST
+  vector<const Node *> nodes;
+  vector<uint8_t> positions;
+  auto append = [&](const vector<const Node *> &siblings)
+  {
+    vector<unsigned int> order(siblings.size());
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(),
+         [&](unsigned int a, unsigned int b)
+         {
+           return (unsigned char)siblings[a]->getSymbol() <
+                  (unsigned char)siblings[b]->getSymbol();
+         });
+    for (unsigned int i : order)
+    {
+      nodes.push_back(siblings[i]);
+      positions.push_back(i);
+    }
+  };
+
+  // Number the nodes in breadth-first order, starting with the paths (the
+  // children of every node follow each other)
+  vector<const Node *> siblings;
+  for (uint32_t id : this->paths)
+    siblings.push_back(this->arena.getNode(id));
+  append(siblings);
+  uint32_t nr_roots = nodes.size();
+
+  vector<char> symbols;
+  vector<uint32_t> frequencies, overlaps, first_children;
+  vector<uint16_t> nr_children;
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    const Node *node = nodes[i];
+    symbols.push_back(node->getSymbol());
+    frequencies.push_back(node->getFrequency());
+    overlaps.push_back(node->getOverlaps());
+    first_children.push_back(nodes.size());
+    nr_children.push_back(node->getNrChildren());
+
+    siblings.clear();
+    for (unsigned int j = 0; j < node->getNrChildren(); j++)
+      siblings.push_back(node->getChild(j));
+    append(siblings);
+  }
+
+  FSTSnapshot::write(path, this->max_depth, this->suffixes_truncated, nr_roots,
+                     symbols, frequencies, overlaps, first_children,
+                     nr_children, positions);
+}
+
+FST *FST::load(const string &path)
+{
+  // Map the snapshot
+  FSTSnapshot snapshot(path);
+  FST *fst = new FST(snapshot.getMaxDepth());
+  fst->suffixes_truncated = snapshot.areSuffixesTruncated();
+
+  // Get the ids of siblings in the order of the saved FST (empty if their
+  // positions are not a permutation)
+  auto in_order = [&](uint32_t begin, unsigned int count)
+  {
+    vector<uint32_t> order(count, FSTSnapshot::NO_NODE);
+    for (uint32_t id = begin; id < begin + count; id++)
+    {
+      unsigned int position = snapshot.getPosition(id);
+      if (position >= count || order[position] != FSTSnapshot::NO_NODE)
+        return vector<uint32_t>();
+      order[position] = id;
+    }
+    return order;
+  };
+
+  // Create the nodes in breadth-first order (the parent of every node is
+  // created before it)
+  vector<Node *> nodes(snapshot.getNrNodes(), NULL);
+  vector<uint32_t> order = in_order(0, snapshot.getNrRoots());
+  if (order.size() != snapshot.getNrRoots())
+  {
+    delete fst;
+    throw runtime_error("FST::load: The roots of " + path +
+                        " are not numbered");
+  }
+  for (uint32_t id : order)
+  {
+    nodes[id] = fst->arena.createNode(snapshot.getSymbol(id),
+                                      snapshot.getFrequency(id), 0, NULL);
+    fst->addPath(nodes[id]);
+  }
+
+  uint32_t next_id = snapshot.getNrRoots();
+  for (uint32_t id = 0; id < snapshot.getNrNodes(); id++)
+  {
+    // Every node has to be the child of an earlier one, in order
+    uint32_t first_child = snapshot.getFirstChild(id);
+    unsigned int nr_children = snapshot.getNrChildren(id);
+    if (nodes[id] == NULL || first_child != next_id ||
+        nr_children > snapshot.getNrNodes() - next_id ||
+        (order = in_order(first_child, nr_children)).size() != nr_children)
+    {
+      delete fst;
+      throw runtime_error("FST::load: The nodes of " + path +
+                          " do not form a tree");
+    }
+    next_id += nr_children;
+
+    Node *node = nodes[id];
+    node->setOverlaps(snapshot.getOverlaps(id));
+
+    // Add the children in the order of the saved FST
+    for (uint32_t child_id : order)
+    {
+      Node *child =
+          fst->arena.createNode(snapshot.getSymbol(child_id),
+                                snapshot.getFrequency(child_id),
+                                node->getLevel() + 1, node);
+      node->addChild(child);
+      nodes[child_id] = child;
+    }
+  }
+
+  return fst;
+}
+
 // --------------------------------------------------
 // Printers
 // --------------------------------------------------
@@ -419,8 +1100,8 @@ bool FST::operator==(const FST &tc) const
     // Get the path with the same symbol
     Node *path_tc = tc.getPath(path->getSymbol());
 
-    // If the path is not equal, the FSTs are not equal
-    if (*path != *path_tc)
+    // If the path is missing or not equal, the FSTs are not equal
+    if (path_tc == NULL || *path != *path_tc)
       return false;
   }
 
@@ -3,11 +3,19 @@
 
 using namespace std;
 
+#include <climits>
+#include <cstdint>
 #include <list>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "gain_heap.h"
+#include "gain_model.h"
 #include "node.h"
+#include "node_arena.h"
+#include "space_saving.h"
+#include "suffix_array.h"
 
 // ---------------------------------------------------------------------------------------------
 // Class FST
@@ -19,11 +27,92 @@ using namespace std;
  */
 class FST
 {
+public:
+  /**
+   * @brief Depth cap meaning that suffixes are inserted completely.
+   */
+  static constexpr unsigned int UNLIMITED_DEPTH = UINT_MAX;
+
+  /**
+   * @brief The minimum number of strings a thread of addStringsInParallel
+   * gets (smaller shards are not worth a thread and a merge).
+   */
+  static constexpr unsigned int MIN_STRINGS_PER_SHARD = 16;
+
+  /**
+   * @brief The number of substrings the SPACE_SAVING backend keeps.
+   */
+  static constexpr size_t SPACE_SAVING_CAPACITY = 1 << 16;
+
+  /**
+   * @brief The ways the substrings of a batch of strings can be counted.
+   */
+  enum CountingBackend
+  {
+    /**
+     * @brief Insert every suffix of every string into the tree.
+     */
+    SUFFIX_TRIE,
+
+    /**
+     * @brief Build the tree from a suffix array of all strings (near-linear
+     * time if the depth is capped).
+     */
+    SUFFIX_ARRAY,
+
+    /**
+     * @brief Count the substrings of up to SpaceSaving::MAX_LENGTH bytes with
+     * a bounded number of counters and build the tree from the most frequent
+     * ones (the memory does not grow with the strings, but the frequencies
+     * are estimates, see addHeavyHitters).
+     */
+    SPACE_SAVING
+  };
+
 private:
   /**
-   * @brief A vector containing the root nodes of all paths in the FST.
+   * @brief The maximum level of the nodes in the FST. Suffixes are only
+   * inserted up to this level, so the frequencies of all nodes up to it are
+   * exact while deeper nodes are never created.
+   *
+   * Once a suffix is cut at this level, the tail of its string is lost, so
+   * getDictionaryEntries only approximates the uncapped FST: the occurrences
+   * of a selected entry are removed window by window instead of per original
+   * string, and the frequencies of the deeper nodes are trimmed by taking the
+   * excess from the most frequent children (Node::trimChildren) instead of
+   * from the children the removed occurrences passed through. As long as no
+   * suffix is cut (see suffixes_truncated), the dictionary equals the one of
+   * the uncapped FST.
+   */
+  unsigned int max_depth;
+
+  /**
+   * @brief Whether a suffix has been cut at the maximum depth (always assumed
+   * for heavy hitters, stored in snapshots).
+   */
+  bool suffixes_truncated;
+
+  /**
+   * @brief The model defining the gain of the nodes (not owned).
+   */
+  const GainModel *gain_model;
+
+  /**
+   * @brief The arena holding all nodes of the FST.
+   */
+  NodeArena arena;
+
+  /**
+   * @brief A vector containing the ids of the root nodes of all paths in the
+   * FST (in the order they were added).
    */
-  std::vector<Node *> paths;
+  std::vector<uint32_t> paths;
+
+  /**
+   * @brief Dense table mapping each symbol to the id of the root node of its
+   * path (NodeArena::NO_NODE if there is none).
+   */
+  uint32_t roots[256];
 
   // --------------------------------------------------
   // Simple setters
@@ -36,7 +125,7 @@ private:
   void addPath(Node *node);
 
   /**
-   * @brief Removes a path from the FST.
+   * @brief Removes a path (and all its nodes) from the FST.
    * @param node The path to remove.
    */
   void removePath(Node *node);
@@ -46,27 +135,59 @@ private:
   // --------------------------------------------------
 
   /**
-   * @brief Adds a substring to the FST.
-   * @param substring The substring to add.
+   * @brief Adds a substring of a string to the FST and counts the overlaps of
+   * its prefixes (the substrings of a string have to be added from left to
+   * right after NodeArena::beginOccurrences).
+   * @param string The string (is not copied).
+   * @param begin The start of the substring within the string.
    * @param length The length of the substring.
+   * @param weight The number of times the string is added.
    */
-  void addSubstring(char *substring, unsigned int length);
+  void addSubstring(const char *string, unsigned int begin,
+                    unsigned int length, unsigned int weight = 1);
 
   /**
-   * @brief Adds overlaps to the FST.
-   * @param string The string to process for overlaps.
+   * @brief Moves the nodes a backend created in another order into the order
+   * addString creates them in: after the nodes that existed before, ordered
+   * by the first occurrence of the substring they represent. The ties of the
+   * dictionary selection are broken in this order.
+   * @param first_occurrences The first occurrence of the substring of every
+   * created node by its id (any increasing position within the added
+   * strings, 0 for the nodes that existed before).
    */
-  void addOverlaps(string string);
+  void orderCreatedNodes(vector<uint64_t> &first_occurrences);
 
   // --------------------------------------------------
   // Subtractors
   // --------------------------------------------------
 
   /**
-   * @brief Subtracts overlaps from the FST.
-   * @param string The string to process for overlaps.
+   * @brief Subtracts the overlaps of all substrings of a string from the FST.
+   * Takes O(length of the string * depth of the FST).
+   * @param str The string to process for overlaps.
+   * @param count The number of copies of the string.
+   */
+  void subtractOverlaps(string_view str, unsigned int count = 1);
+
+  // --------------------------------------------------
+  // Gain selection
+  // --------------------------------------------------
+
+  /**
+   * @brief Builds a heap of all non-root nodes up to a maximum level, keyed by
+   * their gain. Ties are ranked in the order of getSortedGainList.
+   * @param max_level The maximum level of nodes to include in the heap.
+   * @return The heap of node ids.
+   */
+  GainHeap getGainHeap(unsigned int max_level) const;
+
+  /**
+   * @brief Updates a heap built by getGainHeap with the changes recorded by
+   * the arena (and clears them).
+   * @param heap The heap to update.
+   * @param max_level The maximum level the heap was built with.
    */
-  void subtractOverlaps(string string);
+  void updateGainHeap(GainHeap &heap, unsigned int max_level);
 
 public:
   // --------------------------------------------------
@@ -75,14 +196,28 @@ public:
 
   /**
    * @brief Construct a new FST object.
+   * @param max_depth The maximum level of the nodes in the FST (e.g. 7 if only
+   * dictionary entries up to length 8 are needed).
    */
-  FST(void);
+  FST(unsigned int max_depth = UNLIMITED_DEPTH);
 
   /**
    * @brief Destroy the FST object.
    */
   virtual ~FST(void);
 
+  // --------------------------------------------------
+  // Setters
+  // --------------------------------------------------
+
+  /**
+   * @brief Set the model defining the gain of the nodes (used to rank them in
+   * getSortedGainList and getDictionaryEntries).
+   * @param gain_model The gain model (is not copied and has to outlive the
+   * FST) or NULL for the default model.
+   */
+  void setGainModel(const GainModel *gain_model);
+
   // --------------------------------------------------
   // Getters
   // --------------------------------------------------
@@ -93,6 +228,19 @@ public:
    */
   unsigned int getNrPaths() const;
 
+  /**
+   * @brief Get the maximum level of the nodes in the FST.
+   * @return The maximum level (UNLIMITED_DEPTH if suffixes are inserted
+   * completely).
+   */
+  unsigned int getMaxDepth() const;
+
+  /**
+   * @brief Get the model defining the gain of the nodes.
+   * @return The gain model.
+   */
+  const GainModel *getGainModel() const;
+
   /**
    * @brief Get a specific path from the FST by ID.
    * @param i The ID of the path.
@@ -112,27 +260,67 @@ public:
    * @param substring The substring to search for.
    * @return The node representing the substring.
    */
-  Node *getNodeRepresentingSubstring(string substring) const;
+  Node *getNodeRepresentingSubstring(string_view substring) const;
 
   /**
-   * @brief Get a list of all non-root nodes, sorted by gain.
+   * @brief Get a list of all non-root nodes, sorted by the (net) gain of the
+   * gain model.
    * @param max_level The maximum level of nodes to include in the list.
    * @return A list of nodes sorted by gain.
    */
   list<Node *> getSortedGainList(unsigned int max_level = 7) const;
 
+  // --------------------------------------------------
+  // Traversal
+  // --------------------------------------------------
+
+  /**
+   * @brief Visits all nodes of the FST depth-first (paths and children in
+   * the order they were added), see Node::visit.
+   * @param visitor Called as visitor(node, substring) for every node, returns
+   * false to skip the descendants of the node.
+   * @param max_level The maximum level of the nodes to visit.
+   */
+  template <typename Visitor>
+  void visit(Visitor visitor, unsigned int max_level = UNLIMITED_DEPTH) const
+  {
+    for (uint32_t id : this->paths)
+      this->arena.getNode(id)->visit(visitor, max_level);
+  }
+
+  /**
+   * @brief Visits all nodes of the FST depth-first before and after their
+   * descendants, see Node::traverse.
+   * @param pre_visitor Called as pre_visitor(node, substring) before the
+   * descendants of a node, returns false to skip them.
+   * @param post_visitor Called as post_visitor(node, substring) after the
+   * descendants of a node.
+   * @param max_level The maximum level of the nodes to visit.
+   */
+  template <typename PreVisitor, typename PostVisitor>
+  void traverse(PreVisitor pre_visitor, PostVisitor post_visitor,
+                unsigned int max_level = UNLIMITED_DEPTH) const
+  {
+    for (uint32_t id : this->paths)
+      this->arena.getNode(id)->traverse(pre_visitor, post_visitor, max_level);
+  }
+
   // --------------------------------------------------
   // Get dictionary entries (and remove them from the FST)
   // --------------------------------------------------
 
   /**
-   * @brief Get dictionary entries and remove them from the FST.
+   * @brief Get dictionary entries and remove them from the FST. Stops early if
+   * no node reaches the minimum gain of the gain model.
    * @param x The number of dictionary entries to get.
    * @param max_level The maximum level of nodes to include in the dictionary.
+   * @param occurrences If not NULL, receives the number of replaceable
+   * occurrences (frequency - overlaps) of every entry when it was selected.
    * @return A list of dictionary entries.
    */
   list<string> getDictionaryEntries(unsigned int x = 255,
-                                    unsigned int max_level = 7);
+                                    unsigned int max_level = 7,
+                                    vector<unsigned int> *occurrences = NULL);
 
   // --------------------------------------------------
   // Remove substring from the FST
@@ -141,25 +329,58 @@ public:
   /**
    * @brief Subtract a substring from the FST.
    * @param substring The substring to subtract.
+   * @param count The number of occurrences to subtract.
    */
-  void subtractSubstring(string substring);
+  void subtractSubstring(string_view substring, unsigned int count = 1);
 
   // --------------------------------------------------
   // Add string to the FST
   // --------------------------------------------------
 
   /**
-   * @brief Add a string to the FST.
-   * @param string The string to add.
+   * @brief Add a string to the FST. The suffixes are inserted in place, so
+   * neither the string nor its suffixes are copied.
+   * @param string The string to add (does not need to be zero-terminated).
    * @param length The length of the string.
+   * @param weight The number of times the string is added (in one pass, the
+   * result is equal to adding it weight times).
    */
-  void addString(char *string, unsigned int length);
+  void addString(const char *string, unsigned int length,
+                 unsigned int weight = 1);
 
   /**
-   * @brief Add a string to the FST.
+   * @brief Add a string to the FST without copying it (e.g. a line within the
+   * buffer of a block).
    * @param str The string to add.
+   * @param weight The number of times the string is added (in one pass, the
+   * result is equal to adding it weight times).
    */
-  void addString(string str);
+  void addString(string_view str, unsigned int weight = 1);
+
+  // --------------------------------------------------
+  // Remove string from the FST
+  // --------------------------------------------------
+
+  /**
+   * @brief Remove a string added with addString from the FST. Lowers the
+   * frequencies of its suffixes and the overlaps they were counted with, so
+   * the FST is the same as if the string had never been added (nodes reaching
+   * a frequency of 0 are removed).
+   * @param string The string to remove.
+   * @param length The length of the string.
+   * @param weight The number of times the string is removed.
+   * @throws runtime_error If a suffix of the string is not part of the FST.
+   */
+  void removeString(const char *string, unsigned int length,
+                    unsigned int weight = 1);
+
+  /**
+   * @brief Remove a string added with addString from the FST.
+   * @param str The string to remove.
+   * @param weight The number of times the string is removed.
+   * @throws runtime_error If a suffix of the string is not part of the FST.
+   */
+  void removeString(string_view str, unsigned int weight = 1);
 
   // --------------------------------------------------
   // Add a list of strings to the FST
@@ -169,7 +390,81 @@ public:
    * @brief Add a list of strings to the FST.
    * @param strings The list of strings to add.
    */
-  void addStrings(list<string> strings);
+  void addStrings(const list<string> &strings);
+
+  /**
+   * @brief Add strings to the FST using multiple threads. Every thread builds
+   * a partial FST over a contiguous shard of the strings, the partial FSTs are
+   * merged afterwards. The result is equal to adding the strings one by one.
+   * @param strings The strings to add (they are not copied).
+   * @param nr_threads The maximum number of threads (0 to use one per
+   * hardware thread).
+   * @param weights The number of times each string is added (empty to add
+   * every string once).
+   */
+  void addStringsInParallel(const vector<string_view> &strings,
+                            unsigned int nr_threads = 0,
+                            const vector<unsigned int> &weights = {});
+
+  /**
+   * @brief Add strings to the FST by building the nodes from a suffix array of
+   * all strings instead of inserting every suffix. The result is equal to
+   * adding the strings one by one.
+   * @param strings The strings to add.
+   * @param weights The number of times each string is added (empty to add
+   * every string once).
+   */
+  void addStringsWithSuffixArray(const vector<string_view> &strings,
+                                 const vector<unsigned int> &weights = {});
+
+  /**
+   * @brief Add the substrings kept by a SpaceSaving counter to the FST (e.g.
+   * after streaming a whole file through it). Every single byte becomes a
+   * path with its exact frequency and every kept substring a node with its
+   * estimated frequency and overlaps. Prefixes that were not kept are created
+   * with the frequency of their children, as every node occurs at least as
+   * often as its children together. Substrings deeper than the maximum depth
+   * are skipped.
+   * @param counter The counter.
+   */
+  void addHeavyHitters(const SpaceSaving &counter);
+
+  /**
+   * @brief Add strings to the FST using the given backend.
+   * @param strings The strings to add (they are not copied).
+   * @param backend The backend counting the substrings.
+   * @param nr_threads The maximum number of threads for the SUFFIX_TRIE
+   * backend (0 to use one per hardware thread).
+   */
+  void addStrings(const vector<string_view> &strings, CountingBackend backend,
+                  unsigned int nr_threads = 0);
+
+  /**
+   * @brief Add strings with their number of occurrences to the FST using the
+   * given backend (e.g. the distinct lines of a low-cardinality column). The
+   * result is equal to adding every string as often as its weight, but every
+   * string is only processed once.
+   * @param strings The strings to add (they are not copied).
+   * @param weights The number of times each string is added (at least once).
+   * @param backend The backend counting the substrings.
+   * @param nr_threads The maximum number of threads for the SUFFIX_TRIE
+   * backend (0 to use one per hardware thread).
+   */
+  void addStrings(const vector<string_view> &strings,
+                  const vector<unsigned int> &weights, CountingBackend backend,
+                  unsigned int nr_threads = 0);
+
+  // --------------------------------------------------
+  // Merge FSTs
+  // --------------------------------------------------
+
+  /**
+   * @brief Merge another FST into this one by summing the frequencies and
+   * overlaps of all nodes representing the same substring. Merging the FSTs
+   * of two sets of strings gives the FST of their union.
+   * @param fst The FST to merge (must have the same maximum depth).
+   */
+  void merge(const FST &fst);
 
   // --------------------------------------------------
   // Add a substring to the dictionary
@@ -189,6 +484,28 @@ public:
    */
   void handleSubstringAddedToDict(Node *node);
 
+  // --------------------------------------------------
+  // Snapshots
+  // --------------------------------------------------
+
+  /**
+   * @brief Save the FST as a snapshot file (flat node arrays in breadth-first
+   * order, see FSTSnapshot). The snapshot can be mapped with FSTSnapshot to
+   * inspect the FST without rebuilding it, or loaded with load.
+   * @param path The path of the file.
+   * @throws runtime_error If the file cannot be written.
+   */
+  void save(const string &path) const;
+
+  /**
+   * @brief Load an FST from a snapshot file written by save. The file is
+   * mapped and the nodes are created from its arrays in one pass.
+   * @param path The path of the file.
+   * @return The loaded FST (to be deleted by the caller).
+   * @throws runtime_error If the file is not a valid snapshot.
+   */
+  static FST *load(const string &path);
+
   // --------------------------------------------------
   // Printers
   // --------------------------------------------------
@@ -0,0 +1,202 @@
+using namespace std;
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fst_snapshot.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class FSTSnapshot
+// ---------------------------------------------------------------------------------------------
+
+namespace
+{
+  /**
+   * @brief Identifies a snapshot file.
+   */
+  const char MAGIC[8] = {'F', 'S', 'T', 'S', 'N', 'A', 'P', '\0'};
+
+  /**
+   * @brief Rounds an offset up to a multiple of 8.
+   * @param offset The offset.
+   * @return The aligned offset.
+   */
+  uint64_t align(uint64_t offset) { return (offset + 7) / 8 * 8; }
+}
+
+// --------------------------------------------------
+// Constructor and destructor
+// --------------------------------------------------
+
+FSTSnapshot::FSTSnapshot(const string &path) : data(MAP_FAILED), size(0)
+{
+  // Map the whole file
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw runtime_error("FSTSnapshot: Cannot open " + path);
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(Header))
+  {
+    this->size = st.st_size;
+    this->data = mmap(NULL, this->size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+
+  if (this->data == MAP_FAILED)
+    throw runtime_error("FSTSnapshot: Cannot map " + path);
+
+  // Check the header
+  this->header = (const Header *)this->data;
+  const Header &h = *this->header;
+  string error;
+  if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0)
+    error = "is not a snapshot";
+  else if (h.endian_marker != ENDIAN_MARKER)
+    error = "has another byte order";
+  else if (h.version != VERSION)
+    error = "has the unsupported version " + to_string(h.version);
+  else if (h.nr_roots > h.nr_nodes)
+    error = "has more roots than nodes";
+
+  // Every array has to be aligned and lie within the file
+  auto fits = [&](uint64_t offset, size_t element_size)
+  {
+    return offset % element_size == 0 && offset <= this->size &&
+           (this->size - offset) / element_size >= h.nr_nodes;
+  };
+  if (error.empty() &&
+      !(fits(h.frequencies_offset, sizeof(uint32_t)) &&
+        fits(h.overlaps_offset, sizeof(uint32_t)) &&
+        fits(h.first_children_offset, sizeof(uint32_t)) &&
+        fits(h.nr_children_offset, sizeof(uint16_t)) &&
+        fits(h.symbols_offset, sizeof(char)) &&
+        fits(h.positions_offset, sizeof(uint8_t))))
+    error = "is truncated";
+
+  if (!error.empty())
+  {
+    munmap(this->data, this->size);
+    throw runtime_error("FSTSnapshot: " + path + " " + error);
+  }
+
+  // Point the arrays into the file
+  const char *base = (const char *)this->data;
+  this->frequencies = (const uint32_t *)(base + h.frequencies_offset);
+  this->overlaps = (const uint32_t *)(base + h.overlaps_offset);
+  this->first_children = (const uint32_t *)(base + h.first_children_offset);
+  this->nr_children = (const uint16_t *)(base + h.nr_children_offset);
+  this->symbols = base + h.symbols_offset;
+  this->positions = (const uint8_t *)(base + h.positions_offset);
+}
+
+FSTSnapshot::~FSTSnapshot()
+{
+  munmap(this->data, this->size);
+}
+
+// --------------------------------------------------
+// Writing
+// --------------------------------------------------
+
+void FSTSnapshot::write(const string &path, uint32_t max_depth,
+                        bool suffixes_truncated, uint32_t nr_roots,
+                        const vector<char> &symbols,
+                        const vector<uint32_t> &frequencies,
+                        const vector<uint32_t> &overlaps,
+                        const vector<uint32_t> &first_children,
+                        const vector<uint16_t> &nr_children,
+                        const vector<uint8_t> &positions)
+{
+  // Fill the header (the arrays follow it, each aligned to 8 bytes)
+  uint32_t nr_nodes = symbols.size();
+  Header h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, MAGIC, sizeof(MAGIC));
+  h.version = VERSION;
+  h.endian_marker = ENDIAN_MARKER;
+  h.max_depth = max_depth;
+  h.suffixes_truncated = suffixes_truncated;
+  h.nr_nodes = nr_nodes;
+  h.nr_roots = nr_roots;
+  h.frequencies_offset = align(sizeof(Header));
+  h.overlaps_offset =
+      align(h.frequencies_offset + nr_nodes * sizeof(uint32_t));
+  h.first_children_offset =
+      align(h.overlaps_offset + nr_nodes * sizeof(uint32_t));
+  h.nr_children_offset =
+      align(h.first_children_offset + nr_nodes * sizeof(uint32_t));
+  h.symbols_offset = align(h.nr_children_offset + nr_nodes * sizeof(uint16_t));
+  h.positions_offset = align(h.symbols_offset + nr_nodes);
+
+  ofstream file(path, ios::binary | ios::trunc);
+  if (!file)
+    throw runtime_error("FSTSnapshot::write: Cannot open " + path);
+
+  // Write a block at its offset (padding the gap before it)
+  uint64_t written = 0;
+  auto write_at = [&](uint64_t offset, const void *block, size_t bytes)
+  {
+    static const char padding[8] = {0};
+    file.write(padding, offset - written);
+    file.write((const char *)block, bytes);
+    written = offset + bytes;
+  };
+
+  write_at(0, &h, sizeof(h));
+  write_at(h.frequencies_offset, frequencies.data(),
+           nr_nodes * sizeof(uint32_t));
+  write_at(h.overlaps_offset, overlaps.data(), nr_nodes * sizeof(uint32_t));
+  write_at(h.first_children_offset, first_children.data(),
+           nr_nodes * sizeof(uint32_t));
+  write_at(h.nr_children_offset, nr_children.data(),
+           nr_nodes * sizeof(uint16_t));
+  write_at(h.symbols_offset, symbols.data(), nr_nodes);
+  write_at(h.positions_offset, positions.data(), nr_nodes);
+
+  file.close();
+  if (!file)
+    throw runtime_error("FSTSnapshot::write: Cannot write " + path);
+}
+
+// --------------------------------------------------
+// Getters
+// --------------------------------------------------
+
+uint32_t FSTSnapshot::getChild(uint32_t id, char symbol) const
+{
+  // The children (or the roots) are ordered by their unsigned symbol
+  uint32_t begin = id == NO_NODE ? 0 : this->first_children[id];
+  uint32_t end =
+      id == NO_NODE ? this->getNrRoots() : begin + this->nr_children[id];
+  const char *child = lower_bound(
+      this->symbols + begin, this->symbols + end, symbol,
+      [](char a, char b) { return (unsigned char)a < (unsigned char)b; });
+
+  if (child == this->symbols + end || *child != symbol)
+    return NO_NODE;
+  return child - this->symbols;
+}
+
+uint32_t FSTSnapshot::getNodeRepresentingSubstring(string_view substring) const
+{
+  // Follow the symbols of the substring from the roots
+  uint32_t id = NO_NODE;
+  for (char symbol : substring)
+  {
+    id = this->getChild(id, symbol);
+    if (id == NO_NODE)
+      return NO_NODE;
+  }
+  return id;
+}
@@ -0,0 +1,281 @@
+#ifndef FST_SNAPSHOT_H
+#define FST_SNAPSHOT_H
+
+using namespace std;
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ---------------------------------------------------------------------------------------------
+// Class FSTSnapshot
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @class FSTSnapshot
+ * @brief Read-only view on an FST saved by FST::save, mapped into memory.
+ *
+ * A snapshot stores the nodes in breadth-first order as flat arrays (the
+ * symbols, frequencies, overlaps, the id of the first child, the number of
+ * children and the position among its siblings of every node). The roots are
+ * the first nodes and the children of every node follow each other, ordered
+ * by their (unsigned) symbol; the positions keep the order in which the FST
+ * iterates them, so a loaded FST selects the same dictionary. The file
+ * starts with a versioned header holding the offsets of the arrays, which are
+ * used in place: opening a snapshot maps the file and checks the header, the
+ * nodes are only read (and paged in) when they are accessed.
+ *
+ * The arrays are stored in the byte order of the machine that saved them.
+ */
+class FSTSnapshot
+{
+public:
+  /**
+   * @brief The id used to represent "no node".
+   */
+  static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+  /**
+   * @brief The version of the format written by FST::save.
+   */
+  static constexpr uint32_t VERSION = 2;
+
+  /**
+   * @brief Written as a uint32_t to detect snapshots of another byte order.
+   */
+  static constexpr uint32_t ENDIAN_MARKER = 0x01020304;
+
+  /**
+   * @struct Header
+   * @brief The header at the beginning of a snapshot file.
+   */
+  struct Header
+  {
+    /**
+     * @brief Identifies the file as a snapshot ("FSTSNAP\0").
+     */
+    char magic[8];
+
+    /**
+     * @brief The version of the format.
+     */
+    uint32_t version;
+
+    /**
+     * @brief ENDIAN_MARKER in the byte order of the file.
+     */
+    uint32_t endian_marker;
+
+    /**
+     * @brief The maximum depth of the saved FST.
+     */
+    uint32_t max_depth;
+
+    /**
+     * @brief The number of nodes.
+     */
+    uint32_t nr_nodes;
+
+    /**
+     * @brief The number of roots (the paths of the FST).
+     */
+    uint32_t nr_roots;
+
+    /**
+     * @brief Whether a suffix of the saved FST has been cut at its maximum
+     * depth (0 or 1).
+     */
+    uint32_t suffixes_truncated;
+
+    /**
+     * @brief The offsets of the arrays from the start of the file.
+     */
+    uint64_t frequencies_offset;
+    uint64_t overlaps_offset;
+    uint64_t first_children_offset;
+    uint64_t nr_children_offset;
+    uint64_t symbols_offset;
+    uint64_t positions_offset;
+  };
+
+private:
+  /**
+   * @brief The mapped file.
+   */
+  void *data;
+
+  /**
+   * @brief The size of the mapped file in bytes.
+   */
+  size_t size;
+
+  /**
+   * @brief The header of the file.
+   */
+  const Header *header;
+
+  /**
+   * @brief The arrays of the nodes (pointing into the mapped file).
+   */
+  const uint32_t *frequencies;
+  const uint32_t *overlaps;
+  const uint32_t *first_children;
+  const uint16_t *nr_children;
+  const char *symbols;
+  const uint8_t *positions;
+
+public:
+  // --------------------------------------------------
+  // Constructor and destructor
+  // --------------------------------------------------
+
+  /**
+   * @brief Maps a snapshot file into memory.
+   * @param path The path of the file.
+   * @throws runtime_error If the file cannot be mapped or is not a snapshot of
+   * this version and byte order.
+   */
+  FSTSnapshot(const string &path);
+
+  /**
+   * @brief Unmaps the file.
+   */
+  ~FSTSnapshot(void);
+
+  FSTSnapshot(const FSTSnapshot &) = delete;
+  FSTSnapshot &operator=(const FSTSnapshot &) = delete;
+
+  // --------------------------------------------------
+  // Writing
+  // --------------------------------------------------
+
+  /**
+   * @brief Writes a snapshot file (see FST::save).
+   * @param path The path of the file.
+   * @param max_depth The maximum depth of the FST.
+   * @param suffixes_truncated Whether a suffix has been cut at the maximum
+   * depth.
+   * @param nr_roots The number of roots (the first nodes).
+   * @param symbols The symbols of the nodes in breadth-first order.
+   * @param frequencies The frequencies of the nodes.
+   * @param overlaps The overlaps of the nodes.
+   * @param first_children The id of the first child of every node.
+   * @param nr_children The number of children of every node.
+   * @param positions The position of every node among its siblings in the
+   * order the FST iterates them.
+   * @throws runtime_error If the file cannot be written.
+   */
+  static void write(const string &path, uint32_t max_depth,
+                    bool suffixes_truncated, uint32_t nr_roots,
+                    const vector<char> &symbols,
+                    const vector<uint32_t> &frequencies,
+                    const vector<uint32_t> &overlaps,
+                    const vector<uint32_t> &first_children,
+                    const vector<uint16_t> &nr_children,
+                    const vector<uint8_t> &positions);
+
+  // --------------------------------------------------
+  // Getters
+  // --------------------------------------------------
+
+  /**
+   * @brief Gets the maximum depth of the saved FST.
+   * @return The maximum depth.
+   */
+  unsigned int getMaxDepth() const { return this->header->max_depth; }
+
+  /**
+   * @brief Checks if a suffix of the saved FST has been cut at its maximum
+   * depth.
+   * @return True if a suffix has been cut.
+   */
+  bool areSuffixesTruncated() const
+  {
+    return this->header->suffixes_truncated != 0;
+  }
+
+  /**
+   * @brief Gets the number of nodes.
+   * @return The number of nodes.
+   */
+  unsigned int getNrNodes() const { return this->header->nr_nodes; }
+
+  /**
+   * @brief Gets the number of roots (the ids of the roots are 0 to the number
+   * of roots - 1).
+   * @return The number of roots.
+   */
+  unsigned int getNrRoots() const { return this->header->nr_roots; }
+
+  /**
+   * @brief Gets the symbol of a node.
+   * @param id The id of the node.
+   * @return The symbol.
+   */
+  char getSymbol(uint32_t id) const { return this->symbols[id]; }
+
+  /**
+   * @brief Gets the frequency of a node.
+   * @param id The id of the node.
+   * @return The frequency.
+   */
+  unsigned int getFrequency(uint32_t id) const
+  {
+    return this->frequencies[id];
+  }
+
+  /**
+   * @brief Gets the overlaps of a node.
+   * @param id The id of the node.
+   * @return The overlaps.
+   */
+  unsigned int getOverlaps(uint32_t id) const { return this->overlaps[id]; }
+
+  /**
+   * @brief Gets the number of children of a node.
+   * @param id The id of the node.
+   * @return The number of children.
+   */
+  unsigned int getNrChildren(uint32_t id) const
+  {
+    return this->nr_children[id];
+  }
+
+  /**
+   * @brief Gets the first child of a node (the ids of its children follow
+   * each other, ordered by symbol).
+   * @param id The id of the node.
+   * @return The id of the first child.
+   */
+  uint32_t getFirstChild(uint32_t id) const
+  {
+    return this->first_children[id];
+  }
+
+  /**
+   * @brief Gets the position of a node among its siblings (or the roots) in
+   * the order the saved FST iterated them.
+   * @param id The id of the node.
+   * @return The position.
+   */
+  unsigned int getPosition(uint32_t id) const { return this->positions[id]; }
+
+  /**
+   * @brief Gets the child of a node with a symbol (binary search).
+   * @param id The id of the node (NO_NODE to search the roots).
+   * @param symbol The symbol of the child.
+   * @return The id of the child (NO_NODE if there is none).
+   */
+  uint32_t getChild(uint32_t id, char symbol) const;
+
+  /**
+   * @brief Gets the node representing a substring.
+   * @param substring The substring.
+   * @return The id of the node (NO_NODE if there is none).
+   */
+  uint32_t getNodeRepresentingSubstring(string_view substring) const;
+};
+
+#endif
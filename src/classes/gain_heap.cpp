@@ -0,0 +1,110 @@
+using namespace std;
+
+#include <vector>
+
+#include "gain_heap.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class GainHeap
+// ---------------------------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------------------
+// Private functions
+// -----------------------------------------------------------------------------------------
+
+void GainHeap::place(uint32_t pos, const Entry &entry)
+{
+  // Store the entry and remember where it is
+  this->entries[pos] = entry;
+  this->positions[entry.id] = pos;
+}
+
+void GainHeap::siftUp(uint32_t pos)
+{
+  // Move the parents down until the entry has found its place
+  Entry entry = this->entries[pos];
+  while (pos > 0)
+  {
+    uint32_t parent = (pos - 1) / 2;
+    if (!isBefore(entry, this->entries[parent]))
+      break;
+
+    this->place(pos, this->entries[parent]);
+    pos = parent;
+  }
+  this->place(pos, entry);
+}
+
+void GainHeap::siftDown(uint32_t pos)
+{
+  // Move the higher children up until the entry has found its place
+  Entry entry = this->entries[pos];
+  uint32_t size = this->entries.size();
+  while (2 * pos + 1 < size)
+  {
+    uint32_t child = 2 * pos + 1;
+    if (child + 1 < size &&
+        isBefore(this->entries[child + 1], this->entries[child]))
+      child++;
+    if (!isBefore(this->entries[child], entry))
+      break;
+
+    this->place(pos, this->entries[child]);
+    pos = child;
+  }
+  this->place(pos, entry);
+}
+
+// -----------------------------------------------------------------------------------------
+// Public functions
+// -----------------------------------------------------------------------------------------
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+GainHeap::GainHeap(uint32_t capacity) : positions(capacity, NOT_CONTAINED) {}
+
+// --------------------------------------------------
+// Setters
+// --------------------------------------------------
+
+void GainHeap::push(uint32_t id, int gain, uint32_t rank)
+{
+  // Append the entry and restore the heap order
+  this->entries.push_back({gain, rank, id});
+  this->siftUp(this->entries.size() - 1);
+}
+
+void GainHeap::update(uint32_t id, int gain)
+{
+  // Change the gain and move the entry in the direction it has to go
+  uint32_t pos = this->positions[id];
+  int old_gain = this->entries[pos].gain;
+  this->entries[pos].gain = gain;
+
+  if (gain > old_gain)
+    this->siftUp(pos);
+  else if (gain < old_gain)
+    this->siftDown(pos);
+}
+
+void GainHeap::remove(uint32_t id)
+{
+  // Ignore ids that are not contained
+  if (!this->contains(id))
+    return;
+
+  // Move the last entry into the gap and restore the heap order
+  uint32_t pos = this->positions[id];
+  Entry last = this->entries.back();
+  this->entries.pop_back();
+  this->positions[id] = NOT_CONTAINED;
+
+  if (pos < this->entries.size())
+  {
+    this->place(pos, last);
+    this->siftUp(pos);
+    this->siftDown(this->positions[last.id]);
+  }
+}
@@ -0,0 +1,164 @@
+#ifndef GAIN_HEAP_H
+#define GAIN_HEAP_H
+
+using namespace std;
+
+#include <cstdint>
+#include <vector>
+
+// ---------------------------------------------------------------------------------------------
+// Class GainHeap
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @class GainHeap
+ * @brief Indexed binary max-heap of node ids keyed by their gain.
+ *
+ * Every entry additionally carries a rank that breaks ties between equal
+ * gains (the smaller rank wins), so the top of the heap is the same node that
+ * a stable sort by gain would put first. The position of every id in the heap
+ * is stored, so the gain of a single node can be updated (or the node can be
+ * removed) in O(log N).
+ */
+class GainHeap
+{
+public:
+  /**
+   * @brief The position of ids that are not contained in the heap.
+   */
+  static constexpr uint32_t NOT_CONTAINED = UINT32_MAX;
+
+private:
+  /**
+   * @struct Entry
+   * @brief A node id together with its key.
+   */
+  struct Entry
+  {
+    int gain;
+    uint32_t rank;
+    uint32_t id;
+  };
+
+  /**
+   * @brief The entries in heap order.
+   */
+  std::vector<Entry> entries;
+
+  /**
+   * @brief The position of each id in entries (NOT_CONTAINED if absent).
+   */
+  std::vector<uint32_t> positions;
+
+  /**
+   * @brief Checks if an entry has to be placed above another one.
+   * @param entry1 The first entry.
+   * @param entry2 The second entry.
+   * @return True if entry1 has a higher priority than entry2.
+   */
+  static bool isBefore(const Entry &entry1, const Entry &entry2)
+  {
+    return entry1.gain > entry2.gain ||
+           (entry1.gain == entry2.gain && entry1.rank < entry2.rank);
+  }
+
+  /**
+   * @brief Stores an entry at a position (and remembers the position).
+   * @param pos The position.
+   * @param entry The entry.
+   */
+  void place(uint32_t pos, const Entry &entry);
+
+  /**
+   * @brief Moves the entry at a position up until the heap order holds.
+   * @param pos The position of the entry.
+   */
+  void siftUp(uint32_t pos);
+
+  /**
+   * @brief Moves the entry at a position down until the heap order holds.
+   * @param pos The position of the entry.
+   */
+  void siftDown(uint32_t pos);
+
+public:
+  // --------------------------------------------------
+  // Constructor
+  // --------------------------------------------------
+
+  /**
+   * @brief Constructs an empty heap.
+   * @param capacity Every id pushed to the heap must be smaller than this.
+   */
+  GainHeap(uint32_t capacity);
+
+  // --------------------------------------------------
+  // Getters
+  // --------------------------------------------------
+
+  /**
+   * @brief Checks if the heap is empty.
+   * @return True if no id is contained in the heap.
+   */
+  bool isEmpty() const { return this->entries.empty(); }
+
+  /**
+   * @brief Gets the number of ids in the heap.
+   * @return The number of ids.
+   */
+  unsigned int getSize() const { return this->entries.size(); }
+
+  /**
+   * @brief Checks if an id is contained in the heap.
+   * @param id The id.
+   * @return True if the id is contained.
+   */
+  bool contains(uint32_t id) const
+  {
+    return id < this->positions.size() &&
+           this->positions[id] != NOT_CONTAINED;
+  }
+
+  /**
+   * @brief Gets the id with the highest gain (the heap must not be empty).
+   * @return The id.
+   */
+  uint32_t getTop() const { return this->entries.front().id; }
+
+  /**
+   * @brief Gets the gain an id is stored with.
+   * @param id The id (must be contained).
+   * @return The gain.
+   */
+  int getGain(uint32_t id) const
+  {
+    return this->entries[this->positions[id]].gain;
+  }
+
+  // --------------------------------------------------
+  // Setters
+  // --------------------------------------------------
+
+  /**
+   * @brief Adds an id to the heap (it must not be contained yet).
+   * @param id The id.
+   * @param gain The gain of the id.
+   * @param rank The rank breaking ties with equal gains.
+   */
+  void push(uint32_t id, int gain, uint32_t rank);
+
+  /**
+   * @brief Changes the gain of an id (it must be contained).
+   * @param id The id.
+   * @param gain The new gain.
+   */
+  void update(uint32_t id, int gain);
+
+  /**
+   * @brief Removes an id from the heap (if contained).
+   * @param id The id.
+   */
+  void remove(uint32_t id);
+};
+
+#endif
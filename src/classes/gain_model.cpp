@@ -0,0 +1,64 @@
+using namespace std;
+
+#include <climits>
+
+#include "gain_model.h"
+#include "node.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class GainModel
+// ---------------------------------------------------------------------------------------------
+
+int GainModel::getGain(const Node *node) const
+{
+  // The original gain of the node
+  return node->getGain();
+}
+
+int GainModel::getEntryCost(const Node *node) const
+{
+  // Entries are free
+  return 0;
+}
+
+int GainModel::getMinimumGain() const
+{
+  // Every node may be added
+  return INT_MIN;
+}
+
+const GainModel &GainModel::getDefault()
+{
+  static const GainModel model;
+  return model;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Class CodeGainModel
+// ---------------------------------------------------------------------------------------------
+
+CodeGainModel::CodeGainModel(unsigned int code_bits, bool header_cost)
+    : code_bits(code_bits), header_cost(header_cost)
+{
+}
+
+int CodeGainModel::getGain(const Node *node) const
+{
+  // Every replaceable occurrence saves its bytes minus a code
+  int length = node->getLevel() + 1;
+  int replaceable = (int)node->getFrequency() - (int)node->getOverlaps();
+  return replaceable * (8 * length - (int)this->code_bits);
+}
+
+int CodeGainModel::getEntryCost(const Node *node) const
+{
+  // fsst_export stores the bytes of every symbol (its length only in a fixed
+  // size histogram)
+  return this->header_cost ? 8 * (node->getLevel() + 1) : 0;
+}
+
+int CodeGainModel::getMinimumGain() const
+{
+  // Entries that cost more than they save make the output larger
+  return this->header_cost ? 1 : INT_MIN;
+}
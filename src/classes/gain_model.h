@@ -0,0 +1,136 @@
+#ifndef GAIN_MODEL_H
+#define GAIN_MODEL_H
+
+using namespace std;
+
+#include <climits>
+
+class Node;
+
+// ---------------------------------------------------------------------------------------------
+// Class GainModel
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @class GainModel
+ * @brief Strategy defining how much adding the substring of a node to the
+ * dictionary is worth. Used to rank the nodes (NodeCompare, getDictionaryEntries).
+ *
+ * The base class is the original model: (frequency - overlaps) * (level - 1)
+ * without any cost for the dictionary entry itself.
+ */
+class GainModel
+{
+public:
+  // --------------------------------------------------
+  // Constructor and destructor
+  // --------------------------------------------------
+
+  /**
+   * @brief Destroy the GainModel object.
+   */
+  virtual ~GainModel(void) {}
+
+  // --------------------------------------------------
+  // Getters
+  // --------------------------------------------------
+
+  /**
+   * @brief Gets the gain of replacing all replaceable occurrences of the
+   * substring of a node (without the cost of the dictionary entry).
+   * @param node The node.
+   * @return The gain.
+   */
+  virtual int getGain(const Node *node) const;
+
+  /**
+   * @brief Gets the cost of adding the substring of a node to the dictionary.
+   * @param node The node.
+   * @return The cost (in the unit of the gain).
+   */
+  virtual int getEntryCost(const Node *node) const;
+
+  /**
+   * @brief Gets the minimum net gain a node needs to be added to the
+   * dictionary (getDictionaryEntries stops before worse nodes).
+   * @return The minimum net gain.
+   */
+  virtual int getMinimumGain() const;
+
+  /**
+   * @brief Gets the gain minus the cost of the dictionary entry.
+   * @param node The node.
+   * @return The net gain.
+   */
+  int getNetGain(const Node *node) const
+  {
+    return this->getGain(node) - this->getEntryCost(node);
+  }
+
+  /**
+   * @brief Gets the shared instance of the original model.
+   * @return The default model.
+   */
+  static const GainModel &getDefault();
+};
+
+// ---------------------------------------------------------------------------------------------
+// Class CodeGainModel
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @class CodeGainModel
+ * @brief Gain in bits for a symbol table with fixed-width codes: every
+ * replaced occurrence saves its bytes but costs one code. Optionally every
+ * entry costs the bytes it adds to the header written by fsst_export, in which
+ * case only entries with a positive net gain are added.
+ */
+class CodeGainModel : public GainModel
+{
+public:
+  /**
+   * @brief The code width of FSST (lib/fsst/libfsst.hpp).
+   */
+  static constexpr unsigned int FSST_CODE_WIDTH = 8;
+
+  /**
+   * @brief The code width of FSST12 (lib/fsst/libfsst12.hpp).
+   */
+  static constexpr unsigned int FSST12_CODE_WIDTH = 12;
+
+private:
+  /**
+   * @brief The width of a code in bits.
+   */
+  unsigned int code_bits;
+
+  /**
+   * @brief Whether the size of an entry in the header is charged.
+   */
+  bool header_cost;
+
+public:
+  // --------------------------------------------------
+  // Constructor
+  // --------------------------------------------------
+
+  /**
+   * @brief Construct a new CodeGainModel object.
+   * @param code_bits The width of a code in bits.
+   * @param header_cost Whether the size of an entry in the header is charged.
+   */
+  CodeGainModel(unsigned int code_bits = FSST_CODE_WIDTH,
+                bool header_cost = false);
+
+  // --------------------------------------------------
+  // Getters
+  // --------------------------------------------------
+
+  int getGain(const Node *node) const override;
+
+  int getEntryCost(const Node *node) const override;
+
+  int getMinimumGain() const override;
+};
+
+#endif
@@ -9,9 +9,11 @@ using namespace std;
 #include <sstream>
 #include <stdexcept>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "node.h"
+#include "node_arena.h"
 
 // ---------------------------------------------------------------------------------------------
 // Class Node
@@ -34,42 +36,60 @@ void Node::setSymbol(char symbol)
 void Node::setFrequency(unsigned int frequency)
 {
   // Set the frequency of the symbol of this Node
-  this->frequency = frequency;
+  NodeArena *arena = this->getArena();
+  arena->storeValue(this, NodeArena::frequencyOf(this), NodeArena::FREQUENCY,
+                    frequency);
+  arena->recordChange(this);
 }
 
 void Node::setLevel(unsigned int level)
 {
   // Set the level of this Node
-  this->level = level;
+  this->getArena()->storeValue(this, NodeArena::levelOf(this),
+                               NodeArena::LEVEL, level);
 }
 
 void Node::setOverlaps(unsigned int overlaps)
 {
   // Set the overlaps of this Node
-  this->overlaps = overlaps;
+  NodeArena *arena = this->getArena();
+  arena->storeValue(this, NodeArena::overlapsOf(this), NodeArena::OVERLAPS,
+                    overlaps);
+  arena->recordChange(this);
 }
 
 void Node::addChild(Node *node)
 {
   // Add a child to the Node
-  this->children.push_back(node);
+  this->getArena()->getChildPools().insert(NodeArena::childrenOf(this),
+                                           node->getSymbol(), node->getId());
 }
 
 void Node::removeChild(Node *node)
 {
   // Remove a child from the Node
-  for (unsigned int i = 0; i < this->children.size(); i++)
-    if (this->children.at(i) == node)
-      this->children.erase(this->children.begin() + i);
+  NodeArena *arena = this->getArena();
+  arena->getChildPools().erase(NodeArena::childrenOf(this), node->getSymbol());
 
-  // Delete the Node
-  delete (node);
+  // Release the Node (and its subtree) back to the arena
+  arena->releaseSubtree(node->getId());
+}
+
+void Node::reorderChildren(const vector<Node *> &children)
+{
+  // Add the children again in their new order
+  ChildPools &child_pools = this->getArena()->getChildPools();
+  ChildIndex &index = NodeArena::childrenOf(this);
+  child_pools.clear(index);
+  for (Node *child : children)
+    child_pools.insert(index, child->getSymbol(), child->getId());
 }
 
 void Node::setParent(Node *node)
 {
   // Set the parent of this Node
-  this->parent = node;
+  NodeArena::parentOf(this) =
+      (node != NULL) ? node->getId() : NodeArena::NO_NODE;
 }
 
 // -----------------------------------------------------------------------------------------
@@ -83,7 +103,8 @@ void Node::setParent(Node *node)
 Node::Node(const char &symbol, const unsigned int frequency,
            const unsigned int level, Node *parent)
 {
-  // Set all private variables
+  // Set all attributes (the slot may hold the attributes of a released Node)
+  NodeArena::childrenOf(this) = ChildIndex();
   setSymbol(symbol);
   setFrequency(frequency);
   setLevel(level);
@@ -93,9 +114,30 @@ Node::Node(const char &symbol, const unsigned int frequency,
 
 Node::~Node()
 {
-  // Delete all children
-  for (unsigned int i = 0; i < this->children.size(); i++)
-    delete (this->children.at(i));
+  // The children are owned (and freed) by the arena
+}
+
+Node *Node::create(const char &symbol, const unsigned int frequency,
+                   const unsigned int level, Node *parent)
+{
+  // Standalone trees share one arena, so a small tree does not occupy a whole
+  // chunk on its own
+  static NodeArena standalone_arena;
+
+  if (parent == NULL)
+    return standalone_arena.createNode(symbol, frequency, level, NULL);
+
+  Node *node = parent->getArena()->createNode(symbol, frequency, level, parent);
+  parent->addChild(node);
+  return node;
+}
+
+void Node::operator delete(void *ptr)
+{
+  // The Node itself is already destroyed, so only return its slot and release
+  // its descendants
+  NodeArena *arena = NodeArena::of(ptr);
+  arena->releaseSubtree(NodeArena::getId(static_cast<Node *>(ptr)), false);
 }
 
 // --------------------------------------------------
@@ -108,70 +150,82 @@ char Node::getSymbol() const
   return this->symbol;
 }
 
+uint32_t Node::getId() const
+{
+  // Get the id of this Node from its position in the arena
+  return NodeArena::getId(this);
+}
+
+NodeArena *Node::getArena() const
+{
+  // Get the arena this Node is stored in
+  return NodeArena::of(this);
+}
+
 unsigned int Node::getFrequency() const
 {
   // Get the frequency of the symbol of this Node
-  return this->frequency;
+  return this->getArena()->loadValue(this, NodeArena::frequencyOf(this),
+                                     NodeArena::FREQUENCY);
 }
 
 unsigned int Node::getLevel() const
 {
   // Get the level of this node
-  return this->level;
+  return this->getArena()->loadValue(this, NodeArena::levelOf(this),
+                                     NodeArena::LEVEL);
 }
 
 unsigned int Node::getOverlaps() const
 {
   // Get the overlaps of this Node
-  return this->overlaps;
+  return this->getArena()->loadValue(this, NodeArena::overlapsOf(this),
+                                     NodeArena::OVERLAPS);
 }
 
 unsigned int Node::getNrChildren() const
 {
   // Get the number of children of this Node
-  return this->children.size();
+  return NodeArena::childrenOf(this).count;
 }
 
 Node *Node::getChild(unsigned int i) const
 {
   // Get the i-th child of this Node
-  return this->children.at(i);
+  const ChildIndex &children = NodeArena::childrenOf(this);
+  if (i >= children.count)
+    throw out_of_range("Node::getChild: There is no child " + to_string(i));
+
+  NodeArena *arena = this->getArena();
+  return arena->getNode(arena->getChildPools().at(children, i));
 }
 
 Node *Node::getChild(const char &symbol) const
 {
   // Get the child of this Node with the given symbol
-  for (unsigned int i = 0; i < this->children.size(); i++)
-    if (this->children.at(i)->getSymbol() == symbol)
-      return this->children.at(i);
+  NodeArena *arena = this->getArena();
+  uint32_t id =
+      arena->getChildPools().find(NodeArena::childrenOf(this), symbol);
 
   // If no Node with the given symbol was found, return NULL
-  return nullptr;
+  if (id == ChildPools::NO_CHILD)
+    return nullptr;
+
+  return arena->getNode(id);
 }
 
 list<Node *> Node::getDescendants(unsigned int max_level) const
 {
-  // Get all descendants of this Node
+  // Get all descendants of this Node (in pre-order)
   list<Node *> descendants;
-
-  // If the maximum level is not reached yet
-  if (this->getLevel() < max_level)
-  {
-    // For all children of this Node
-    for (unsigned int i = 0; i < this->children.size(); i++)
-    {
-      // Add the child to the list of descendants
-      descendants.push_back(this->children.at(i));
-
-      // Get the descendants of the child
-      list<Node *> childDescendants =
-          this->children.at(i)->getDescendants(max_level);
-
-      // Add the descendants of the child to the list of descendants
-      descendants.insert(descendants.end(), childDescendants.begin(),
-                         childDescendants.end());
-    }
-  }
+  this->visit(
+      [&](Node *node, string_view)
+      {
+        if (node != this)
+          descendants.push_back(node);
+        return true;
+      },
+      max_level);
 
   return descendants;
 }
@@ -179,30 +233,19 @@ list<Node *> Node::getDescendants(unsigned int max_level) const
 Node *Node::getParent() const
 {
   // Get the parent of this Node
-  return this->parent;
+  uint32_t parent = NodeArena::parentOf(this);
+  if (parent == NodeArena::NO_NODE)
+    return NULL;
+  return this->getArena()->getNode(parent);
 }
 
 list<Node *> Node::getAncestors() const
 {
-  // Get the ancestors of the Node
+  // Get the ancestors of the Node (starting with the root)
   list<Node *> ancestors;
-
-  // Get the parent of the Node
-  Node *parent = this->getParent();
-
-  // If the parent is not NULL
-  if (parent != NULL)
-  {
-    // Get the ancestors of the parent
-    list<Node *> parentAncestors = parent->getAncestors();
-
-    // Add the ancestors of the parent to the list of ancestors
-    ancestors.insert(ancestors.end(), parentAncestors.begin(),
-                     parentAncestors.end());
-
-    // Add the parent to the list of ancestors
-    ancestors.push_back(parent);
-  }
+  for (Node *parent = this->getParent(); parent != NULL;
+       parent = parent->getParent())
+    ancestors.push_front(parent);
 
   return ancestors;
 }
@@ -217,7 +260,7 @@ Node *Node::getRoot() const
   return this->getParent()->getRoot();
 }
 
-Node *Node::getNodeRepresentingSubstring(string substring) const
+Node *Node::getNodeRepresentingSubstring(string_view substring) const
 {
   // Check if the character of this node is the first character of the substring
   if (this->getSymbol() == substring.at(0))
@@ -260,23 +303,13 @@ int Node::getGain() const
 
 string Node::getSubstring() const
 {
-  // Get the substring represented by this Node
-  string substring = "";
+  // Collect the symbols from this Node up to the root
+  string substring;
+  for (const Node *node = this; node != NULL; node = node->getParent())
+    substring.push_back(node->getSymbol());
 
-  // Get the parent of this Node
-  Node *parent = this->getParent();
-
-  // If the parent is not NULL
-  if (parent != NULL)
-  {
-    // Get the substring of the parent
-    substring = parent->getSubstring();
-  }
-
-  // Add the symbol of this Node to the substring
-  substring += this->getSymbol();
-
-  // Return the substring
+  // Return them in the order of the substring
+  reverse(substring.begin(), substring.end());
   return substring;
 }
 
@@ -309,52 +342,48 @@ bool Node::overlapsPossible() const
 void Node::raiseFrequency(unsigned int increase)
 {
   // Raise the frequency of this Node
-  this->frequency += increase;
+  this->setFrequency(this->getFrequency() + increase);
 }
 
 void Node::lowerFrequency(unsigned int decrease)
 {
   // Lower the frequency of this Node
   // The frequency of a node can never be negative
-  if (this->frequency < decrease)
-    this->setFrequencyToZero();
-  else
-    this->frequency -= decrease;
+  unsigned int frequency = this->getFrequency();
+  this->setFrequency(frequency < decrease ? 0 : frequency - decrease);
 }
 
 void Node::setFrequencyToZero()
 {
   // Delete the node
-  this->frequency = 0;
+  this->setFrequency(0);
 }
 
 void Node::raiseOverlaps(unsigned int increase)
 {
   // Raise the overlaps of this Node
-  this->overlaps += increase;
+  this->setOverlaps(this->getOverlaps() + increase);
 }
 
 void Node::lowerOverlaps(unsigned int decrease)
 {
   // Lower the overlaps of this Node
   // The overlaps of a node can never be negative
-  if (this->overlaps < decrease)
-    this->setOverlapsToZero();
-  else
-    this->overlaps -= decrease;
+  unsigned int overlaps = this->getOverlaps();
+  this->setOverlaps(overlaps < decrease ? 0 : overlaps - decrease);
 }
 
 void Node::setOverlapsToZero()
 {
   // Set the overlaps of this Node to zero
-  this->overlaps = 0;
+  this->setOverlaps(0);
 }
 
 // --------------------------------------------------
 // Adders
 // --------------------------------------------------
 
-void Node::addSubstring(char *substring, const unsigned int length)
+void Node::addSubstring(const char *substring, const unsigned int length)
 {
   // If the substring is only as long as the current Node, raise the frequency
   if (length - 1 <= this->getLevel())
@@ -375,8 +404,8 @@ void Node::addSubstring(char *substring, const unsigned int length)
     if (node == NULL)
     {
       // Create a new Node at level + 1
-      node = new Node(substring[this->getLevel() + 1], 0, this->getLevel() + 1,
-                      this);
+      node = this->getArena()->createNode(substring[this->getLevel() + 1], 0,
+                                          this->getLevel() + 1, this);
 
       // Add the Node to the Node
       this->addChild(node);
@@ -387,74 +416,54 @@ void Node::addSubstring(char *substring, const unsigned int length)
   }
 }
 
-void Node::addSubstring(string substring)
+void Node::addSubstring(string_view substring)
 {
-  // Get the length of the substring
-  unsigned int length = substring.length();
-
-  // Get the char array of the substring
-  char *charArray = new char[length + 1];
-  strcpy(charArray, substring.c_str());
-
-  // Call the addSubstring function
-  this->addSubstring(charArray, length);
-
-  // Delete the char array
-  delete[] charArray;
+  // Call the addSubstring function on the characters of the view
+  this->addSubstring(substring.data(), substring.length());
 }
 
-void Node::addOverlaps(string str)
+void Node::merge(const Node *node)
 {
-  // Check if overlaps are at all possible in this Node
-  if (this->overlapsPossible())
-  {
-    // If yes get the substring of this Node
-    string substring = this->getSubstring();
-
-    // Check how often the substring can occur with and without overlaps within
-    // the string
-    unsigned int withoutOverlaps =
-        string_helpers::number_of_occurrences_without_overlap(str, substring);
-    unsigned int withOverlaps =
-        string_helpers::number_of_occurrences_with_overlap(str, substring);
+  // Pairs of a node of the other tree and the node it is merged into
+  vector<pair<const Node *, Node *>> stack = {{node, this}};
 
-    // Compute the number of overlaps
-    unsigned int overlaps = withOverlaps - withoutOverlaps;
-
-    // Raise the overlaps of this Node
-    this->raiseOverlaps(overlaps);
-  }
-
-  // Get the number of children of this Node
-  unsigned int numberOfChildren = this->getNrChildren();
-
-  // If there are children
-  if (numberOfChildren > 0)
+  while (!stack.empty())
   {
-    // Get the symbols contained in the string
-    set<char> symbols = string_helpers::get_contained_chars(str);
+    const Node *from = stack.back().first;
+    Node *into = stack.back().second;
+    stack.pop_back();
 
-    // For each symbol
-    for (set<char>::iterator it = symbols.begin(); it != symbols.end(); it++)
-    {
-      // Get the child with the symbol
-      Node *child = this->getChild(*it);
+    // Sum the frequencies and overlaps
+    into->raiseFrequency(from->getFrequency());
+    into->raiseOverlaps(from->getOverlaps());
 
-      // If there is a child with the symbol
-      if (child != NULL)
+    // Merge the children (creating the missing ones)
+    for (unsigned int i = 0; i < from->getNrChildren(); i++)
+    {
+      Node *child = from->getChild(i);
+      Node *into_child = into->getChild(child->getSymbol());
+      if (into_child == NULL)
       {
-        // Call the addOverlaps function of the child
-        child->addOverlaps(str);
+        into_child = into->getArena()->createNode(child->getSymbol(), 0,
+                                                  child->getLevel(), into);
+        into->addChild(into_child);
       }
+      stack.push_back({child, into_child});
     }
   }
 }
 
+void Node::addOverlaps(string_view str, unsigned int count)
+{
+  // Count the overlapping occurrences in the subtree of this Node
+  this->updateOverlaps(str, false, count);
+}
+
 // --------------------------------------------------
 // Subtractors
 // --------------------------------------------------
 
-void Node::subtractSubstring(string substring)
+void Node::subtractSubstring(string_view substring, unsigned int count)
 {
   // cout << "Node::subtractSubstring: " << substring << endl;
 
@@ -472,7 +481,7 @@ void Node::subtractSubstring(string substring)
       if (child != NULL)
       {
         // Call the subtractSubstring function of the child
-        child->subtractSubstring(substring.substr(1));
+        child->subtractSubstring(substring.substr(1), count);
 
         // If the frequency of the child is zero, delete the child
         if (child->getFrequency() == 0)
@@ -484,65 +493,85 @@ void Node::subtractSubstring(string substring)
       {
         // Throw an exception
         throw runtime_error("Node::subtractSubstring: The substring " +
-                            substring + " is not part of the tree");
+                            string(substring) + " is not part of the tree");
       }
     }
 
-    // Remove one frequency from this Node (after the child has been removed to
-    // be sure that there was no exception)
-    this->lowerFrequency(1);
+    // Remove the occurrences from this Node (after the child has been removed
+    // to be sure that there was no exception)
+    this->lowerFrequency(count);
   }
   else
   {
     // Throw an exception
-    throw runtime_error("Node::subtractSubstring: The substring " + substring +
-                        " is not part of the tree");
+    throw runtime_error("Node::subtractSubstring: The substring " +
+                        string(substring) + " is not part of the tree");
   }
 }
 
-void Node::subtractOverlaps(string str)
+void Node::trimChildren()
 {
-  // Check if overlaps are at all possible in this Node
-  if (this->overlapsPossible())
-  {
-    // If yes get the substring of this Node
-    string substring = this->getSubstring();
-
-    // Check how often the substring can occur with and without overlaps within
-    // the string
-    unsigned int withoutOverlaps =
-        string_helpers::number_of_occurrences_without_overlap(str, substring);
-    unsigned int withOverlaps =
-        string_helpers::number_of_occurrences_with_overlap(str, substring);
-
-    // Compute the number of overlaps
-    unsigned int overlaps = withOverlaps - withoutOverlaps;
+  // Sum up the frequencies of the children
+  unsigned int children_frequency = 0;
+  for (unsigned int i = 0; i < this->getNrChildren(); i++)
+    children_frequency += this->getChild(i)->getFrequency();
 
-    // Lower the overlaps of this Node
-    this->lowerOverlaps(overlaps);
+  // As long as the children are more frequent than this Node
+  while (children_frequency > this->getFrequency())
+  {
+    // Get the most frequent child
+    Node *child = this->getChild(0U);
+    for (unsigned int i = 1; i < this->getNrChildren(); i++)
+      if (this->getChild(i)->getFrequency() > child->getFrequency())
+        child = this->getChild(i);
+
+    // Lower its frequency and trim its own children
+    child->lowerFrequency(1);
+    child->trimChildren();
+    children_frequency--;
+
+    // If the frequency of the child is zero, delete the child
+    if (child->getFrequency() == 0)
+      this->removeChild(child);
   }
+}
 
-  // Get the number of children of this Node
-  unsigned int numberOfChildren = this->getNrChildren();
+void Node::subtractOverlaps(string_view str, unsigned int count)
+{
+  // Remove the overlapping occurrences in the subtree of this Node
+  this->updateOverlaps(str, true, count);
+}
 
-  // If there are children
-  if (numberOfChildren > 0)
-  {
-    // Get the symbols contained in the string
-    set<char> symbols = string_helpers::get_contained_chars(str);
+void Node::updateOverlaps(string_view str, bool subtract, unsigned int count)
+{
+  // Count the occurrences of the substrings in a new string
+  NodeArena *arena = this->getArena();
+  arena->beginOccurrences();
 
-    // For each symbol
-    for (set<char>::iterator it = symbols.begin(); it != symbols.end(); it++)
+  // Start at every occurrence of the substring of this Node (from left to
+  // right, so the occurrences of every Node are counted in order)
+  string substring = this->getSubstring();
+  for (size_t begin = str.find(substring); begin != string_view::npos;
+       begin = str.find(substring, begin + 1))
+  {
+    // Follow the string through the subtree, every Node on the way represents
+    // a substring occurring at begin
+    Node *node = this;
+    size_t end = begin + substring.length();
+    while (node != NULL)
     {
-      // Get the child with the symbol
-      Node *child = this->getChild(*it);
-
-      // If there is a child with the symbol
-      if (child != NULL)
+      // Occurrences overlapping the last replaceable one cannot be replaced
+      if (arena->countOccurrence(node, begin, end))
       {
-        // Call the subtractOverlaps function of the child
-        child->subtractOverlaps(str);
+        if (subtract)
+          node->lowerOverlaps(count);
+        else
+          node->raiseOverlaps(count);
       }
+
+      if (end == str.length())
+        break;
+      node = node->getChild(str[end++]);
     }
   }
 }
@@ -557,50 +586,64 @@ list<string> Node::getRepresentedSubstrings() const
   // Get the strings represented by this Node
   list<string> strings;
 
-  // If the Node is a leaf
-  if (this->getNrChildren() == 0)
-  {
-    // Cache the substring
-    string substring = this->getSubstring();
+  // Add every distinct substring as often as it is represented
+  string buffer;
+  for (const pair<string_view, unsigned int> &substring :
+       this->getRepresentedSubstringCounts(buffer))
+    strings.insert(strings.end(), substring.second, string(substring.first));
 
-    // Add the substring frequency times to the list of strings
-    for (unsigned int i = 0; i < this->getFrequency(); i++)
-    {
-      strings.push_back(substring);
-    }
-  }
-  else
-  {
-    // For all children of this Node
-    for (unsigned int i = 0; i < this->getNrChildren(); i++)
-    {
-      // Get the strings represented by the child
-      list<string> childStrings = this->getChild(i)->getRepresentedSubstrings();
+  return strings;
+}
 
-      // Add the strings represented by the child to the list of strings
-      strings.splice(strings.end(), childStrings);
-    }
+vector<pair<string_view, unsigned int>>
+Node::getRepresentedSubstringCounts(string &buffer) const
+{
+  // The position and length of every represented substring in the buffer with
+  // its number of copies
+  vector<tuple<size_t, size_t, unsigned int>> positions;
 
-    // There might also be substrings ending at this Node
-    // Cache the own substring
-    string substring = this->getSubstring();
+  // The number of strings represented by the children of each Node on the
+  // current path
+  vector<unsigned int> counts;
 
-    // Get the size of strings
-    unsigned int size = strings.size();
+  this->traverse(
+      [&](Node *, string_view)
+      {
+        counts.push_back(0);
+        return true;
+      },
+      [&](Node *node, string_view substring)
+      {
+        // The strings of the children come first, there might also be
+        // substrings ending at this Node: the substring is represented
+        // (frequency - number of strings of the children) times
+        unsigned int count = counts.back();
+        counts.pop_back();
+        if (count < node->getFrequency())
+        {
+          positions.emplace_back(buffer.size(), substring.length(),
+                                 node->getFrequency() - count);
+          buffer.append(substring);
+        }
 
-    // Add the substring (frequency - size) times to the list of strings
-    for (unsigned int i = 0; i < (this->getFrequency() - size); i++)
-    {
-      strings.push_back(substring);
-    }
-  }
+        // The Node represents at least as many strings as its frequency
+        if (!counts.empty())
+          counts.back() += max(count, node->getFrequency());
+      });
 
-  return strings;
+  // Point into the buffer (once it does not grow anymore)
+  vector<pair<string_view, unsigned int>> substrings;
+  substrings.reserve(positions.size());
+  for (const tuple<size_t, size_t, unsigned int> &position : positions)
+    substrings.emplace_back(
+        string_view(buffer).substr(get<0>(position), get<1>(position)),
+        get<2>(position));
+
+  return substrings;
 }
 
-tuple<int, list<string>>
-Node::deleteFullStringOccurrencesStartingAtThisNode(string substring,
-                                                    unsigned int pos)
+int Node::deleteFullStringOccurrencesStartingAtThisNode(string_view substring,
+                                                        unsigned int pos)
 {
   // Throw an exception if pos is higher than the length of the substring
   if (pos > substring.length())
@@ -618,14 +661,11 @@ Node::deleteFullStringOccurrencesStartingAtThisNode(string substring,
       // Get the frequency of this Node
       int frequency = this->getFrequency();
 
-      // Get all the substrings represented by this Node
-      list<string> strings = this->getRepresentedSubstrings();
-
       // Set the frequency of this Node to zero
       this->setFrequencyToZero();
 
       // Return the frequency
-      return {frequency, strings};
+      return frequency;
     }
     else
     {
@@ -637,15 +677,15 @@ Node::deleteFullStringOccurrencesStartingAtThisNode(string substring,
       {
         // Call the deleteFullStringOccurrencesStartingAtThisNode function of the
         // child with the substring and the next position
-        tuple<int, list<string>> return_value =
+        int frequency =
             child->deleteFullStringOccurrencesStartingAtThisNode(substring,
                                                                  pos + 1);
 
         // If the substring was found
-        if (get<0>(return_value) > 0)
+        if (frequency > 0)
         {
           // Lower the frequency of this Node by the frequency of the substring
-          this->lowerFrequency(get<0>(return_value));
+          this->lowerFrequency(frequency);
 
           // If the frequency of the child is zero, delete the child
           if (child->getFrequency() == 0)
@@ -653,68 +693,57 @@ Node::deleteFullStringOccurrencesStartingAtThisNode(string substring,
             this->removeChild(child);
           }
 
-          // Return the frequency and the represented_substrings of the
-          // substring
-          return return_value;
+          // Return the frequency of the substring
+          return frequency;
         }
       }
     }
   }
 
   // Return -1 if the substring was not found
-  return {-1, list<string>()};
+  return -1;
 }
 
 void Node::deleteFullStringOccurrences(string substring)
 {
-  // If the first character of the substring is the symbol of this Node
-  if (substring[0] == this->getSymbol())
-  {
-    // Check if there are occurrences of the substring starting at this Node (and
-    // delete them)
-    deleteFullStringOccurrencesStartingAtThisNode(substring, 0);
-  }
-
-  // Pass the call to all children
-  for (int i = this->getNrChildren() - 1; i >= 0; i--)
-  {
-    // Get the child
-    Node *child = this->getChild(static_cast<unsigned int>(i));
-
-    // If the child is not NULL
-    if (child != NULL)
-    {
-      // Call the deleteFullStringOccurrences function of the child
-      child->deleteFullStringOccurrences(substring);
-
-      // If the frequency of the child is zero, delete the child
-      if (child->getFrequency() == 0)
+  this->traverse(
+      [&](Node *node, string_view)
       {
-        this->removeChild(child);
-      }
-    }
-  }
-
-  // Overlaps correction
-  if (this->getOverlaps() > 0)
-  {
-    // Set the overlaps to zero
-    this->setOverlapsToZero();
-
-    // Get all substrings this node represents
-    list<string> represented_substrings = this->getRepresentedSubstrings();
-
-    // Get the original strings by removing contained substrings
-    list<string> original_strings =
-        string_helpers::delete_contained_substrings(represented_substrings);
+        // If the first character of the substring is the symbol of the Node,
+        // check if there are occurrences of the substring starting at the Node
+        // (and delete them)
+        if (substring[0] == node->getSymbol())
+          node->deleteFullStringOccurrencesStartingAtThisNode(substring, 0);
+        return true;
+      },
+      [&](Node *node, string_view)
+      {
+        // Overlaps correction
+        if (node->getOverlaps() > 0)
+        {
+          // Set the overlaps to zero
+          node->setOverlapsToZero();
+
+          // Get all substrings the node represents
+          string buffer;
+          vector<pair<string_view, unsigned int>> represented_substrings =
+              node->getRepresentedSubstringCounts(buffer);
+
+          // Get the original strings by removing contained substrings
+          vector<pair<string_view, unsigned int>> original_strings =
+              string_helpers::delete_contained_substrings(
+                  represented_substrings);
+
+          // For all original strings add the overlaps again
+          for (const pair<string_view, unsigned int> &original_string :
+               original_strings)
+            node->addOverlaps(original_string.first, original_string.second);
+        }
 
-    // For all original strings
-    for (string original_string : original_strings)
-    {
-      // Add the overlaps again
-      this->addOverlaps(original_string);
-    }
-  }
+        // If the frequency of a descendant is zero, delete it
+        if (node != this && node->getFrequency() == 0)
+          node->getParent()->removeChild(node);
+      });
 }
 
 // --------------------------------------------------
@@ -763,8 +792,8 @@ bool Node::operator==(const Node &node) const
     // Get the children with the same symbol of node
     Node *child2 = node.getChild(child1->getSymbol());
 
-    // If the children are not equal
-    if (*child1 != *child2)
+    // If the child is missing or the children are not equal
+    if (child2 == NULL || *child1 != *child2)
     {
       return false;
     }
@@ -810,53 +839,36 @@ bool Node::operator>=(const Node &node) const
 
 void Node::printTree()
 {
-  // Print the Node
-  for (unsigned int i = 0; i < this->getLevel(); i++)
-  {
-    if (i == 0)
-      cout << "|";
-    else
-      cout << "-";
-
-    if (i == this->getLevel() - 1)
-      cout << " ";
-    else
-      cout << "-";
-  }
-
-  cout << this->getSymbol() << ": " << this->getFrequency() << " (-"
-       << this->getOverlaps() << ")" << endl;
-
-  // Print all children
-  for (unsigned int i = 0; i < this->getNrChildren(); i++)
-    this->getChild(i)->printTree();
+  // Print the (sub)tree
+  cout << this->toString();
 }
 
 string Node::toString()
 {
   stringstream ss;
 
-  // Print the Node
-  for (unsigned int i = 0; i < this->getLevel(); i++)
-  {
-    if (i == 0)
-      ss << "|";
-    else
-      ss << "-";
-
-    if (i == this->getLevel() - 1)
-      ss << " ";
-    else
-      ss << "-";
-  }
-
-  ss << this->getSymbol() << ": " << this->getFrequency() << " (-"
-     << this->getOverlaps() << ")"
-     << "\n";
+  // Print every Node of the (sub)tree
+  this->visit(
+      [&](Node *node, string_view)
+      {
+        for (unsigned int i = 0; i < node->getLevel(); i++)
+        {
+          if (i == 0)
+            ss << "|";
+          else
+            ss << "-";
+
+          if (i == node->getLevel() - 1)
+            ss << " ";
+          else
+            ss << "-";
+        }
 
-  // Print all children
-  for (unsigned int i = 0; i < this->getNrChildren(); i++)
-    ss << this->getChild(i)->toString();
+        ss << node->getSymbol() << ": " << node->getFrequency() << " (-"
+           << node->getOverlaps() << ")"
+           << "\n";
+        return true;
+      });
 
   return ss.str();
 }
@@ -868,6 +880,7 @@ string Node::toString()
 
 bool NodeCompare::operator()(const Node *node1, const Node *node2) const
 {
-  // Is compared using the gain
-  return *node1 > *node2;
+  // Is compared using the (net) gain of the model
+  return this->gain_model->getNetGain(node1) >
+         this->gain_model->getNetGain(node2);
 }
@@ -3,12 +3,21 @@
 
 using namespace std;
 
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <list>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "../helpers/string_helpers.h"
+#include "child_index.h"
+#include "gain_model.h"
+
+class NodeArena;
 
 // ---------------------------------------------------------------------------------------------
 // Class Node
@@ -17,43 +26,28 @@ using namespace std;
 /**
  * @class Node
  * @brief Represents a node in a tree.
+ *
+ * Every Node lives in a NodeArena, it can only be created by an arena (see
+ * Node::create), never on the stack or inside another object. Nodes created
+ * inside an FST share the arena of the FST, Nodes created on their own share a
+ * single arena for all standalone trees. A Node is a single byte within its
+ * chunk, all other attributes are stored in parallel arrays by the arena.
  */
 class Node
 {
 private:
-  /**
-   * @brief The frequency of occurrence of this symbol.
-   */
-  unsigned int frequency;
-
-  /**
-   * @brief Level in the tree hierarchy (zero-indexed: root = 0; child of root =
-   * 1, etc.).
-   */
-  unsigned int level;
-
-  /**
-   * @brief Number of overlaps (= number of times the substring represented by
-   * this node can not be replaced in the original data due to overlaps with
-   * another occurrence of this substring).
-   */
-  unsigned int overlaps;
-
   /**
    * @brief The symbol this node represents.
+   *
+   * This is the only member stored in the Node object itself. The level, the
+   * frequency of occurrence, the number of overlaps (= number of times the
+   * substring represented by this node can not be replaced in the original
+   * data due to overlaps with another occurrence of this substring), the
+   * parent and the children are stored in the arrays of the chunk of the
+   * NodeArena the Node lives in.
    */
   char symbol;
 
-  /**
-   * @brief The children of this node.
-   */
-  std::vector<Node *> children;
-
-  /**
-   * @brief The parent node of this node.
-   */
-  Node *parent;
-
   // --------------------------------------------------
   // Setters
   // --------------------------------------------------
@@ -89,20 +83,36 @@ private:
   void addChild(Node *node);
 
   /**
-   * @brief Removes a child node from this node.
+   * @brief Removes a child node (and its subtree) from this node.
    * @param node The node to remove.
    */
   void removeChild(Node *node);
 
+  /**
+   * @brief Changes the order in which the children of this node are iterated.
+   * @param children All children of this node in their new order.
+   */
+  void reorderChildren(const vector<Node *> &children);
+
   /**
    * @brief Sets the parent of this node.
    * @param node The node to set as parent.
    */
   void setParent(Node *node);
 
-public:
   /**
-   * @brief Constructs a node.
+   * @brief Raises or lowers the overlaps of this node and its descendants by
+   * the number of their occurrences in a string that cannot be replaced
+   * because they overlap an earlier occurrence. Takes O(length of the string *
+   * depth of the subtree).
+   * @param str The string.
+   * @param subtract True to lower the overlaps, false to raise them.
+   * @param count The number of copies of the string.
+   */
+  void updateOverlaps(string_view str, bool subtract, unsigned int count);
+
+  /**
+   * @brief Constructs a node in a slot of an arena (see NodeArena::createNode).
    * @param symbol The symbol this node represents.
    * @param frequency The frequency of occurrence of this symbol.
    * @param level The level of this node in the tree hierarchy.
@@ -111,10 +121,35 @@ public:
   Node(const char &symbol, const unsigned int frequency,
        const unsigned int level, Node *parent);
 
+  friend class NodeArena;
+  friend class FST;
+
+public:
+  /**
+   * @brief Creates a node as a child of its parent (in the arena of the
+   * parent). A node without a parent is created in the arena shared by all
+   * standalone trees (which is not thread-safe).
+   * @param symbol The symbol this node represents.
+   * @param frequency The frequency of occurrence of this symbol.
+   * @param level The level of this node in the tree hierarchy.
+   * @param parent The parent node of this node (NULL for a standalone root).
+   * @return The new node (to be freed with delete).
+   */
+  static Node *create(const char &symbol, const unsigned int frequency,
+                      const unsigned int level, Node *parent);
+
   /**
-   * @brief Destructs the node.
+   * @brief Destructs the node (not virtual, a Node is not meant to be derived
+   * from).
    */
-  virtual ~Node(void);
+  ~Node(void);
+
+  /**
+   * @brief Returns the slot of a deleted Node and the slots of all its
+   * descendants to its arena.
+   * @param ptr The Node.
+   */
+  static void operator delete(void *ptr);
 
   // --------------------------------------------------
   // Getters
@@ -126,6 +161,18 @@ public:
    */
   char getSymbol() const;
 
+  /**
+   * @brief Gets the id of this node within its arena.
+   * @return The id.
+   */
+  uint32_t getId() const;
+
+  /**
+   * @brief Gets the arena this node is stored in.
+   * @return The arena.
+   */
+  NodeArena *getArena() const;
+
   /**
    * @brief Gets the frequency of occurrence of this symbol.
    * @return The frequency.
@@ -194,7 +241,7 @@ public:
    * @param substring The substring.
    * @return The node that represents the substring.
    */
-  Node *getNodeRepresentingSubstring(string substring) const;
+  Node *getNodeRepresentingSubstring(string_view substring) const;
 
   /**
    * @brief Gets the gain of this node.
@@ -258,22 +305,30 @@ public:
 
   /**
    * @brief Adds a substring to this node.
-   * @param substring The substring to add.
+   * @param substring The substring to add (is not copied).
    * @param length The length of the substring.
    */
-  void addSubstring(char *substring, unsigned int length);
+  void addSubstring(const char *substring, unsigned int length);
 
   /**
    * @brief Adds a substring to this node.
    * @param substring The substring to add.
    */
-  void addSubstring(string substring);
+  void addSubstring(string_view substring);
+
+  /**
+   * @brief Adds the frequencies and overlaps of another tree (representing
+   * the same symbol) to this node and its descendants, creating missing nodes.
+   * @param node The root of the tree to merge.
+   */
+  void merge(const Node *node);
 
   /**
    * @brief Adds overlaps to this node.
    * @param original_string The original string.
+   * @param count The number of copies of the original string.
    */
-  void addOverlaps(string original_string);
+  void addOverlaps(string_view original_string, unsigned int count = 1);
 
   // --------------------------------------------------
   // Subtractors
@@ -282,14 +337,25 @@ public:
   /**
    * @brief Subtracts a substring from this node.
    * @param substring The substring to subtract.
+   * @param count The number of occurrences to subtract.
+   */
+  void subtractSubstring(string_view substring, unsigned int count = 1);
+
+  /**
+   * @brief Lowers the frequencies of the descendants of this node (following
+   * the most frequent child) until no node has children that are more frequent
+   * than the node itself. Needed if suffixes were only inserted up to a maximum
+   * depth, because then a subtracted suffix may end above the node its
+   * occurrence was inserted down to.
    */
-  void subtractSubstring(string substring);
+  void trimChildren();
 
   /**
    * @brief Subtracts overlaps from this node.
    * @param original_string The original string.
+   * @param count The number of copies of the original string.
    */
-  void subtractOverlaps(string original_string);
+  void subtractOverlaps(string_view original_string, unsigned int count = 1);
 
   // --------------------------------------------------
   // Functions to modify occurrence counts when a substring is added to the
@@ -302,16 +368,26 @@ public:
    */
   list<string> getRepresentedSubstrings() const;
 
+  /**
+   * @brief Gets the distinct substrings represented by this node with the
+   * number of times they are represented (in the order of
+   * getRepresentedSubstrings()), without copying a substring per occurrence.
+   * @param buffer The buffer the substrings are stored in (the returned views
+   * point into it).
+   * @return The represented substrings with their number of copies.
+   */
+  vector<pair<string_view, unsigned int>>
+  getRepresentedSubstringCounts(string &buffer) const;
+
   /**
    * @brief Deletes all full occurrences of a substring starting at this node.
    * @param substring The substring to delete occurrences of.
    * @param pos The position to start deleting from.
-   * @return A tuple containing the number of occurrences deleted and a list of
-   * deleted substrings.
+   * @return The number of occurrences deleted (-1 if the substring was not
+   * found).
    */
-  tuple<int, list<string>>
-  deleteFullStringOccurrencesStartingAtThisNode(string substring,
-                                                unsigned int pos);
+  int deleteFullStringOccurrencesStartingAtThisNode(string_view substring,
+                                                    unsigned int pos);
 
   /**
    * @brief Deletes all full occurrences of a substring in this node.
@@ -319,6 +395,37 @@ public:
    */
   void deleteFullStringOccurrences(string substring);
 
+  // --------------------------------------------------
+  // Traversal
+  // --------------------------------------------------
+
+  /**
+   * @brief Visits this node and its descendants depth-first (the children in
+   * the order they were added) without recursion and without allocating per
+   * node.
+   * Every node is passed together with the substring it represents, which is
+   * extended on the way down instead of walking up the parents.
+   * @param visitor Called as visitor(node, substring) for every node, returns
+   * false to skip the descendants of the node.
+   * @param max_level The maximum level of the nodes to visit.
+   */
+  template <typename Visitor>
+  void visit(Visitor visitor, unsigned int max_level = UINT_MAX) const;
+
+  /**
+   * @brief Visits this node and its descendants depth-first like visit, but
+   * also calls a visitor after the descendants of a node are visited.
+   * @param pre_visitor Called as pre_visitor(node, substring) before the
+   * descendants of a node, returns false to skip them.
+   * @param post_visitor Called as post_visitor(node, substring) after the
+   * descendants of a node. It may remove the node it visits from its parent
+   * (but no other node).
+   * @param max_level The maximum level of the nodes to visit.
+   */
+  template <typename PreVisitor, typename PostVisitor>
+  void traverse(PreVisitor pre_visitor, PostVisitor post_visitor,
+                unsigned int max_level = UINT_MAX) const;
+
   // --------------------------------------------------
   // Comparison operators
   // --------------------------------------------------
@@ -394,13 +501,100 @@ public:
  */
 struct NodeCompare
 {
+  /**
+   * @brief The model defining the gain of the nodes.
+   */
+  const GainModel *gain_model;
+
+  /**
+   * @brief Constructs a comparator.
+   * @param gain_model The model defining the gain of the nodes.
+   */
+  NodeCompare(const GainModel *gain_model = &GainModel::getDefault())
+      : gain_model(gain_model)
+  {
+  }
+
   /**
    * @brief Compares two nodes.
    * @param node1 The first node to compare.
    * @param node2 The second node to compare.
-   * @return True if node1's gain is less than node2's gain, false otherwise.
+   * @return True if node1's (net) gain is greater than node2's gain, false
+   * otherwise.
    */
   bool operator()(const Node *node1, const Node *node2) const;
 };
 
+// ---------------------------------------------------------------------------------------------
+// Template functions of class Node
+// ---------------------------------------------------------------------------------------------
+
+template <typename Visitor>
+void Node::visit(Visitor visitor, unsigned int max_level) const
+{
+  // A visit is a traversal without a post visitor
+  this->traverse(visitor, [](Node *, string_view) {}, max_level);
+}
+
+template <typename PreVisitor, typename PostVisitor>
+void Node::traverse(PreVisitor pre_visitor, PostVisitor post_visitor,
+                    unsigned int max_level) const
+{
+  // A node on the current path with the position of its next child
+  struct Frame
+  {
+    Node *node;
+    unsigned int next_child;
+    unsigned int nr_children;
+  };
+
+  if (this->getLevel() > max_level)
+    return;
+
+  // The substring of the current node (the first length symbols of the
+  // buffer) and the path leading to it
+  string substring = this->getSubstring();
+  size_t length = substring.size();
+  vector<Frame> path;
+
+  // Entering a node visits it and puts it on the path (with the children to
+  // visit)
+  auto enter = [&](Node *node)
+  {
+    bool descend = pre_visitor(node, string_view(substring.data(), length)) &&
+                   (max_level == UINT_MAX || node->getLevel() < max_level);
+    path.push_back({node, 0, descend ? node->getNrChildren() : 0});
+  };
+
+  enter((Node *)this);
+  while (!path.empty())
+  {
+    // Enter the next child of the current node
+    Frame &frame = path.back();
+    if (frame.next_child < frame.nr_children)
+    {
+      Node *child = frame.node->getChild(frame.next_child++);
+      if (length == substring.size())
+        substring.resize(2 * length + 1);
+      substring[length++] = child->getSymbol();
+      enter(child);
+      continue;
+    }
+
+    // Leave the node once all its children are visited
+    Node *node = frame.node;
+    path.pop_back();
+    post_visitor(node, string_view(substring.data(), length));
+    length--;
+
+    // The post visitor may have removed the node from its parent
+    if (!path.empty() &&
+        path.back().node->getNrChildren() < path.back().nr_children)
+    {
+      path.back().next_child--;
+      path.back().nr_children--;
+    }
+  }
+}
+
 #endif
\ No newline at end of file
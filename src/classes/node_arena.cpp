@@ -0,0 +1,194 @@
+using namespace std;
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "node_arena.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class NodeArena
+// ---------------------------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------------------
+// Private functions
+// -----------------------------------------------------------------------------------------
+
+void NodeArena::addChunk()
+{
+  // Allocate a chunk that is aligned to its own size, so Nodes can find it by
+  // masking their address
+  void *memory = aligned_alloc(CHUNK_BYTES, CHUNK_BYTES);
+  if (memory == NULL)
+    throw bad_alloc();
+
+  // Initialise the header
+  Chunk *chunk = static_cast<Chunk *>(memory);
+  chunk->arena = this;
+  chunk->first_id = this->chunks.size() * NODES_PER_CHUNK;
+
+  // Add the chunk
+  this->chunks.push_back(chunk);
+}
+
+// -----------------------------------------------------------------------------------------
+// Public functions
+// -----------------------------------------------------------------------------------------
+
+// --------------------------------------------------
+// Constructor and destructor
+// --------------------------------------------------
+
+NodeArena::NodeArena()
+    : size(0), tracking(false), nodes_created(false), occurrence_stamp(0)
+{
+}
+
+NodeArena::~NodeArena()
+{
+  // Mark all released slots (their Nodes are already destroyed)
+  vector<bool> released(this->size, false);
+  for (uint32_t id : this->free_ids)
+    released[id] = true;
+
+  // Destroy all Nodes that are still alive
+  for (uint32_t id = 0; id < this->size; id++)
+    if (!released[id])
+      this->getNode(id)->~Node();
+
+  // Free all chunks at once
+  for (Chunk *chunk : this->chunks)
+    free(chunk);
+}
+
+// --------------------------------------------------
+// Allocation
+// --------------------------------------------------
+
+void *NodeArena::allocate()
+{
+  // Remember the allocation for an index over the Nodes
+  if (this->tracking)
+    this->nodes_created = true;
+
+  // Reuse a released slot if possible
+  if (!this->free_ids.empty())
+  {
+    uint32_t id = this->free_ids.back();
+    this->free_ids.pop_back();
+    return this->getNode(id);
+  }
+
+  // Otherwise take the next unused slot (adding a chunk if necessary)
+  if (this->size == this->chunks.size() * NODES_PER_CHUNK)
+    this->addChunk();
+
+  return this->getNode(this->size++);
+}
+
+Node *NodeArena::createNode(const char &symbol, const unsigned int frequency,
+                            const unsigned int level, Node *parent)
+{
+  // Construct the Node in a free slot
+  return ::new (this->allocate()) Node(symbol, frequency, level, parent);
+}
+
+void NodeArena::deallocate(uint32_t id)
+{
+  // Remember the slot for reuse
+  this->free_ids.push_back(id);
+}
+
+void NodeArena::releaseSubtree(uint32_t id, bool destroy_root)
+{
+  // Iteratively destroy the Node and all its descendants
+  vector<uint32_t> stack = {id};
+
+  while (!stack.empty())
+  {
+    uint32_t node_id = stack.back();
+    Node *node = this->getNode(node_id);
+    stack.pop_back();
+
+    // Remember the children before the Node is destroyed (through the arrays,
+    // the root may already be destroyed)
+    ChildIndex &children = childrenOf(node);
+    for (unsigned int i = 0; i < children.count; i++)
+      stack.push_back(this->child_pools.at(children, i));
+
+    // Destroy the Node and return its slot (and its child block, its values
+    // are reset)
+    this->child_pools.clear(children);
+    this->storeValue(node, levelOf(node), LEVEL, 0);
+    this->storeValue(node, frequencyOf(node), FREQUENCY, 0);
+    this->storeValue(node, overlapsOf(node), OVERLAPS, 0);
+    if (node_id != id || destroy_root)
+      node->~Node();
+    this->deallocate(node_id);
+
+    // Remember the release for an index over the Nodes
+    if (this->tracking)
+      this->released_ids.push_back(node_id);
+  }
+}
+
+// --------------------------------------------------
+// Change tracking
+// --------------------------------------------------
+
+void NodeArena::setTracking(bool tracking)
+{
+  // Start or stop recording with no changes recorded
+  this->tracking = tracking;
+  this->clearChanges();
+}
+
+void NodeArena::clearChanges()
+{
+  // Forget all recorded changes
+  this->changed_ids.clear();
+  this->released_ids.clear();
+  this->nodes_created = false;
+}
+
+// --------------------------------------------------
+// Occurrence counting
+// --------------------------------------------------
+
+void NodeArena::beginOccurrences()
+{
+  // A new stamp invalidates all counted occurrences at once (they only have to
+  // be reset when the stamps wrap around)
+  if (++this->occurrence_stamp == 0)
+  {
+    for (unique_ptr<Occurrence[]> &block : this->occurrences)
+      if (block)
+        fill(block.get(), block.get() + NODES_PER_CHUNK, Occurrence());
+    this->occurrence_stamp = 1;
+  }
+}
+
+void NodeArena::releaseOccurrences()
+{
+  // Free all blocks (new blocks start without a counted occurrence)
+  this->occurrences.clear();
+  this->occurrences.shrink_to_fit();
+}
+
+// --------------------------------------------------
+// Getters
+// --------------------------------------------------
+
+unsigned int NodeArena::getNrNodes() const
+{
+  // All slots handed out minus the released ones
+  return this->size - this->free_ids.size();
+}
+
+unsigned int NodeArena::getCapacity() const
+{
+  // Get the number of slots handed out
+  return this->size;
+}
@@ -0,0 +1,531 @@
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+
+using namespace std;
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "child_index.h"
+#include "node.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class NodeArena
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @class NodeArena
+ * @brief Contiguous pool holding all Nodes of one tree (or one FST).
+ *
+ * Nodes are stored in fixed-size chunks that are aligned to their own size,
+ * so every Node can find its arena by masking its own address. Nodes refer to
+ * each other by 32-bit ids, which are stable for the lifetime of the Node.
+ * All Nodes are freed at once when the arena is destroyed.
+ *
+ * A chunk stores its Nodes as parallel arrays: the Node objects themselves
+ * only hold their symbol, the level (8 bit), frequency and overlaps (16 bit
+ * each), the parent and the ChildIndex of the Node at the same position
+ * follow in separate arrays. Values that do not fit into their narrow field
+ * are stored in a dense block of wide values of their chunk instead (the
+ * field holds its maximum).
+ */
+class NodeArena
+{
+public:
+  /**
+   * @brief The id used to represent "no node" (e.g. the parent of a root).
+   */
+  static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+  /**
+   * @brief The size (and alignment) of a chunk in bytes.
+   */
+  static constexpr size_t CHUNK_BYTES = 1 << 18;
+
+  /**
+   * @brief The number of bytes stored in a chunk per Node.
+   */
+  static constexpr size_t BYTES_PER_NODE = sizeof(Node) + sizeof(uint8_t) +
+                                           2 * sizeof(uint16_t) +
+                                           sizeof(uint32_t) +
+                                           sizeof(ChildIndex);
+  static_assert(sizeof(Node) == sizeof(char),
+                "A Node must only hold its symbol");
+
+private:
+  /**
+   * @struct Chunk
+   * @brief Header at the beginning of every chunk (the arrays follow it).
+   */
+  struct Chunk
+  {
+    /**
+     * @brief The arena this chunk belongs to.
+     */
+    NodeArena *arena;
+
+    /**
+     * @brief The id of the first Node in this chunk.
+     */
+    uint32_t first_id;
+  };
+
+  /**
+   * @brief The offset of the first array within a chunk.
+   */
+  static constexpr size_t HEADER_BYTES =
+      (sizeof(Chunk) + alignof(ChildIndex) - 1) / alignof(ChildIndex) *
+      alignof(ChildIndex);
+
+public:
+  /**
+   * @brief The number of Nodes stored in a single chunk (a multiple of 8, so
+   * every array stays aligned).
+   */
+  static constexpr uint32_t NODES_PER_CHUNK =
+      (CHUNK_BYTES - HEADER_BYTES) / BYTES_PER_NODE / 8 * 8;
+
+  /**
+   * @brief The fields of a Node whose values may be stored wide.
+   */
+  enum WideField
+  {
+    LEVEL,
+    FREQUENCY,
+    OVERLAPS,
+    NR_WIDE_FIELDS
+  };
+
+private:
+  /**
+   * @brief The offsets of the arrays within a chunk.
+   */
+  static constexpr size_t NODES_OFFSET = HEADER_BYTES;
+  static constexpr size_t LEVELS_OFFSET =
+      NODES_OFFSET + NODES_PER_CHUNK * sizeof(Node);
+  static constexpr size_t FREQUENCIES_OFFSET =
+      LEVELS_OFFSET + NODES_PER_CHUNK * sizeof(uint8_t);
+  static constexpr size_t OVERLAPS_OFFSET =
+      FREQUENCIES_OFFSET + NODES_PER_CHUNK * sizeof(uint16_t);
+  static constexpr size_t PARENTS_OFFSET =
+      OVERLAPS_OFFSET + NODES_PER_CHUNK * sizeof(uint16_t);
+  static constexpr size_t CHILDREN_OFFSET =
+      PARENTS_OFFSET + NODES_PER_CHUNK * sizeof(uint32_t);
+
+  /**
+   * @brief All chunks of this arena.
+   */
+  std::vector<Chunk *> chunks;
+
+  /**
+   * @brief The number of slots handed out so far (= the next unused id).
+   */
+  uint32_t size;
+
+  /**
+   * @brief Ids of released slots that can be reused.
+   */
+  std::vector<uint32_t> free_ids;
+
+  /**
+   * @brief The pools holding the child blocks of all Nodes.
+   */
+  ChildPools child_pools;
+
+  /**
+   * @brief The values of the Nodes that do not fit into their narrow field,
+   * one block per field and chunk indexed like the chunk (allocated when a
+   * value of the chunk overflows first, so the hottest Nodes, e.g. the roots,
+   * stay a single indexed access).
+   */
+  std::vector<std::unique_ptr<unsigned int[]>> wide_values[NR_WIDE_FIELDS];
+
+  /**
+   * @brief Whether changes of the Nodes are recorded.
+   */
+  bool tracking;
+
+  /**
+   * @brief Ids of the Nodes whose frequency or overlaps changed (may contain
+   * duplicates) since the changes were last cleared.
+   */
+  std::vector<uint32_t> changed_ids;
+
+  /**
+   * @brief Ids of the Nodes released since the changes were last cleared.
+   */
+  std::vector<uint32_t> released_ids;
+
+  /**
+   * @brief Whether a Node was allocated since the changes were last cleared.
+   */
+  bool nodes_created;
+
+  /**
+   * @brief The stamp of the string whose occurrences are currently counted.
+   */
+  uint32_t occurrence_stamp;
+
+  /**
+   * @struct Occurrence
+   * @brief The last counted occurrence of a Node.
+   */
+  struct Occurrence
+  {
+    /**
+     * @brief The stamp of the string the occurrence is in.
+     */
+    uint32_t stamp;
+
+    /**
+     * @brief The end of the last non-overlapping occurrence in the string with
+     * the stamp.
+     */
+    uint32_t end;
+  };
+
+  /**
+   * @brief The last counted occurrences of the Nodes, one block per chunk
+   * (allocated when first needed, see releaseOccurrences).
+   */
+  std::vector<std::unique_ptr<Occurrence[]>> occurrences;
+
+  /**
+   * @brief Adds a new chunk to the arena.
+   */
+  void addChunk();
+
+  /**
+   * @brief Gets the chunk a pointer points into.
+   * @param ptr The pointer.
+   * @return The chunk.
+   */
+  static Chunk *chunkOf(const void *ptr)
+  {
+    return reinterpret_cast<Chunk *>(reinterpret_cast<uintptr_t>(ptr) &
+                                     ~(uintptr_t)(CHUNK_BYTES - 1));
+  }
+
+  /**
+   * @brief Gets the entry of a Node in one of the arrays of its chunk.
+   * @param node The Node.
+   * @param offset The offset of the array within the chunk.
+   * @return The entry.
+   */
+  template <typename T>
+  static T &fieldOf(const Node *node, size_t offset)
+  {
+    char *chunk = reinterpret_cast<char *>(chunkOf(node));
+    size_t i = reinterpret_cast<const char *>(node) - (chunk + NODES_OFFSET);
+    return reinterpret_cast<T *>(chunk + offset)[i];
+  }
+
+  /**
+   * @brief Gets the level of a Node (narrow).
+   * @param node The Node.
+   * @return The level (or UINT8_MAX if it is stored wide).
+   */
+  static uint8_t &levelOf(const Node *node)
+  {
+    return fieldOf<uint8_t>(node, LEVELS_OFFSET);
+  }
+
+  /**
+   * @brief Gets the frequency of a Node (narrow).
+   * @param node The Node.
+   * @return The frequency (or UINT16_MAX if it is stored wide).
+   */
+  static uint16_t &frequencyOf(const Node *node)
+  {
+    return fieldOf<uint16_t>(node, FREQUENCIES_OFFSET);
+  }
+
+  /**
+   * @brief Gets the overlaps of a Node (narrow).
+   * @param node The Node.
+   * @return The overlaps (or UINT16_MAX if they are stored wide).
+   */
+  static uint16_t &overlapsOf(const Node *node)
+  {
+    return fieldOf<uint16_t>(node, OVERLAPS_OFFSET);
+  }
+
+  /**
+   * @brief Gets the id of the parent of a Node.
+   * @param node The Node.
+   * @return The id of the parent (NO_NODE for a root).
+   */
+  static uint32_t &parentOf(const Node *node)
+  {
+    return fieldOf<uint32_t>(node, PARENTS_OFFSET);
+  }
+
+  /**
+   * @brief Gets the children of a Node.
+   * @param node The Node.
+   * @return The index of the children.
+   */
+  static ChildIndex &childrenOf(const Node *node)
+  {
+    return fieldOf<ChildIndex>(node, CHILDREN_OFFSET);
+  }
+
+  /**
+   * @brief Reads a value of a Node from its narrow field (or the wide values).
+   * @param node The Node.
+   * @param narrow The narrow field.
+   * @param field The field.
+   * @return The value.
+   */
+  template <typename T>
+  unsigned int loadValue(const Node *node, T narrow, WideField field) const
+  {
+    if (narrow != numeric_limits<T>::max())
+      return narrow;
+    uint32_t id = getId(node);
+    return this->wide_values[field][id / NODES_PER_CHUNK][id % NODES_PER_CHUNK];
+  }
+
+  /**
+   * @brief Writes a value of a Node to its narrow field, or to the wide values
+   * if it does not fit.
+   * @param node The Node.
+   * @param narrow The narrow field.
+   * @param field The field.
+   * @param value The value.
+   */
+  template <typename T>
+  void storeValue(const Node *node, T &narrow, WideField field,
+                  unsigned int value)
+  {
+    if (value < numeric_limits<T>::max())
+    {
+      narrow = value;
+      return;
+    }
+
+    // Allocate the block of the chunk when its first value overflows
+    uint32_t id = getId(node);
+    vector<unique_ptr<unsigned int[]>> &blocks = this->wide_values[field];
+    uint32_t block = id / NODES_PER_CHUNK;
+    if (block >= blocks.size())
+      blocks.resize(this->chunks.size());
+    if (!blocks[block])
+      blocks[block].reset(new unsigned int[NODES_PER_CHUNK]);
+    narrow = numeric_limits<T>::max();
+    blocks[block][id % NODES_PER_CHUNK] = value;
+  }
+
+  friend class Node;
+
+public:
+  // --------------------------------------------------
+  // Constructor and destructor
+  // --------------------------------------------------
+
+  /**
+   * @brief Constructs an empty arena.
+   */
+  NodeArena(void);
+
+  /**
+   * @brief Destroys the arena and all Nodes in it.
+   */
+  ~NodeArena(void);
+
+  NodeArena(const NodeArena &) = delete;
+  NodeArena &operator=(const NodeArena &) = delete;
+
+  // --------------------------------------------------
+  // Allocation
+  // --------------------------------------------------
+
+  /**
+   * @brief Allocates an uninitialised slot for a Node.
+   * @return A pointer to the slot (to be constructed with placement new).
+   */
+  void *allocate();
+
+  /**
+   * @brief Creates a new Node in this arena.
+   * @param symbol The symbol the Node represents.
+   * @param frequency The frequency of the symbol.
+   * @param level The level of the Node.
+   * @param parent The parent of the Node (NULL for a root).
+   * @return The new Node.
+   */
+  Node *createNode(const char &symbol, const unsigned int frequency,
+                   const unsigned int level, Node *parent);
+
+  /**
+   * @brief Returns a slot to the arena without destroying the Node in it.
+   * @param id The id of the slot.
+   */
+  void deallocate(uint32_t id);
+
+  /**
+   * @brief Destroys a Node and all its descendants and returns their slots.
+   * @param id The id of the Node.
+   * @param destroy_root False if the Node itself is already destroyed (see
+   * Node::operator delete).
+   */
+  void releaseSubtree(uint32_t id, bool destroy_root = true);
+
+  // --------------------------------------------------
+  // Change tracking
+  // --------------------------------------------------
+
+  /**
+   * @brief Starts or stops recording changes of the Nodes (e.g. to keep an
+   * index over the Nodes up to date). Clears the recorded changes.
+   * @param tracking True to record changes.
+   */
+  void setTracking(bool tracking);
+
+  /**
+   * @brief Records that the frequency or overlaps of a Node changed (if
+   * changes are tracked).
+   * @param node The Node.
+   */
+  void recordChange(const Node *node)
+  {
+    if (this->tracking)
+      this->changed_ids.push_back(getId(node));
+  }
+
+  /**
+   * @brief Gets the ids of the Nodes that changed since the last clear.
+   * @return The ids (may contain duplicates and released Nodes).
+   */
+  const std::vector<uint32_t> &getChangedIds() const
+  {
+    return this->changed_ids;
+  }
+
+  /**
+   * @brief Gets the ids of the Nodes released since the last clear.
+   * @return The ids.
+   */
+  const std::vector<uint32_t> &getReleasedIds() const
+  {
+    return this->released_ids;
+  }
+
+  /**
+   * @brief Checks if a Node was allocated since the last clear.
+   * @return True if a Node was allocated.
+   */
+  bool haveNodesBeenCreated() const { return this->nodes_created; }
+
+  /**
+   * @brief Clears the recorded changes.
+   */
+  void clearChanges();
+
+  // --------------------------------------------------
+  // Occurrence counting
+  // --------------------------------------------------
+
+  /**
+   * @brief Starts counting the occurrences of the Nodes within a new string.
+   */
+  void beginOccurrences();
+
+  /**
+   * @brief Counts an occurrence of the substring represented by a Node within
+   * the current string. The occurrences of a Node have to be counted from left
+   * to right; they are replaced greedily, like
+   * string_helpers::number_of_occurrences_without_overlap does.
+   * @param node The Node.
+   * @param begin The start of the occurrence within the string.
+   * @param end The end (exclusive) of the occurrence within the string.
+   * @return True if the occurrence overlaps the last replaceable one (so it
+   * cannot be replaced).
+   */
+  bool countOccurrence(const Node *node, uint32_t begin, uint32_t end)
+  {
+    uint32_t id = getId(node);
+    uint32_t block = id / NODES_PER_CHUNK;
+    if (block >= this->occurrences.size())
+      this->occurrences.resize(this->chunks.size());
+    if (!this->occurrences[block])
+      this->occurrences[block].reset(new Occurrence[NODES_PER_CHUNK]());
+    Occurrence &occurrence = this->occurrences[block][id % NODES_PER_CHUNK];
+
+    // The occurrence overlaps if it starts before the last replaceable one of
+    // the same string ends
+    if (occurrence.stamp == this->occurrence_stamp && begin < occurrence.end)
+      return true;
+
+    occurrence.stamp = this->occurrence_stamp;
+    occurrence.end = end;
+    return false;
+  }
+
+  /**
+   * @brief Frees the memory used to count occurrences (e.g. once all strings
+   * are added). It is allocated again when occurrences are counted.
+   */
+  void releaseOccurrences();
+
+  // --------------------------------------------------
+  // Getters
+  // --------------------------------------------------
+
+  /**
+   * @brief Gets a Node by its id.
+   * @param id The id of the Node.
+   * @return The Node.
+   */
+  Node *getNode(uint32_t id) const
+  {
+    Chunk *chunk = this->chunks[id / NODES_PER_CHUNK];
+    return reinterpret_cast<Node *>(reinterpret_cast<char *>(chunk) +
+                                    NODES_OFFSET) +
+           id % NODES_PER_CHUNK;
+  }
+
+  /**
+   * @brief Gets the id of a Node stored in an arena.
+   * @param node The Node.
+   * @return The id of the Node.
+   */
+  static uint32_t getId(const Node *node)
+  {
+    Chunk *chunk = chunkOf(node);
+    const Node *first = reinterpret_cast<const Node *>(
+        reinterpret_cast<const char *>(chunk) + NODES_OFFSET);
+    return chunk->first_id + (uint32_t)(node - first);
+  }
+
+  /**
+   * @brief Gets the arena a Node is stored in.
+   * @param node The Node.
+   * @return The arena.
+   */
+  static NodeArena *of(const void *node) { return chunkOf(node)->arena; }
+
+  /**
+   * @brief Gets the pools holding the child blocks of all Nodes.
+   * @return The child pools.
+   */
+  ChildPools &getChildPools() { return this->child_pools; }
+
+  /**
+   * @brief Gets the number of Nodes currently alive in this arena.
+   * @return The number of Nodes.
+   */
+  unsigned int getNrNodes() const;
+
+  /**
+   * @brief Gets the number of slots handed out so far (alive or released).
+   * Every id of this arena is smaller than this number.
+   * @return The number of slots.
+   */
+  unsigned int getCapacity() const;
+};
+
+#endif
@@ -0,0 +1,69 @@
+using namespace std;
+
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "sliding_window_fst.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class SlidingWindowFST
+// ---------------------------------------------------------------------------------------------
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+SlidingWindowFST::SlidingWindowFST(size_t nr_lines, unsigned int max_depth)
+    : nr_lines(nr_lines), fst(max_depth)
+{
+  // The window has to hold at least one line
+  if (nr_lines == 0)
+    throw invalid_argument("SlidingWindowFST: The window cannot hold a line");
+}
+
+// --------------------------------------------------
+// Getters
+// --------------------------------------------------
+
+list<string> SlidingWindowFST::getDictionaryEntries(unsigned int x,
+                                                    unsigned int max_level) const
+{
+  // Selecting entries changes the FST, so select them on a copy. The copy is
+  // built from the lines (not merged from the FST, whose nodes keep the order
+  // of older lines), so its ties are broken like in an FST built from scratch
+  FST copy(this->fst.getMaxDepth());
+  copy.setGainModel(this->fst.getGainModel());
+  for (const string &line : this->lines)
+    copy.addString(line);
+  return copy.getDictionaryEntries(x, max_level);
+}
+
+// --------------------------------------------------
+// Stream
+// --------------------------------------------------
+
+void SlidingWindowFST::addLine(string_view line)
+{
+  // Add the line
+  this->lines.emplace_back(line);
+  this->fst.addString(this->lines.back());
+
+  // Remove the oldest line if the window is full
+  if (this->lines.size() > this->nr_lines)
+  {
+    this->fst.removeString(this->lines.front());
+    this->lines.pop_front();
+  }
+}
+
+void SlidingWindowFST::clear()
+{
+  // Remove the lines in the order they were added
+  while (!this->lines.empty())
+  {
+    this->fst.removeString(this->lines.front());
+    this->lines.pop_front();
+  }
+}
@@ -0,0 +1,112 @@
+#ifndef SLIDING_WINDOW_FST_H
+#define SLIDING_WINDOW_FST_H
+
+using namespace std;
+
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <string>
+#include <string_view>
+
+#include "fst.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class SlidingWindowFST
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @class SlidingWindowFST
+ * @brief Keeps an FST in sync with the last lines of an append-only stream.
+ *
+ * Every appended line is added to the FST. Once the window is full, the
+ * oldest line is removed again (FST::removeString), so the FST always equals
+ * the FST built from scratch over the lines in the window. The lines are
+ * copied, the stream does not need to keep them alive.
+ */
+class SlidingWindowFST
+{
+private:
+  /**
+   * @brief The maximum number of lines in the window.
+   */
+  size_t nr_lines;
+
+  /**
+   * @brief The lines in the window (oldest first).
+   */
+  deque<string> lines;
+
+  /**
+   * @brief The FST of the lines in the window.
+   */
+  FST fst;
+
+public:
+  // --------------------------------------------------
+  // Constructor
+  // --------------------------------------------------
+
+  /**
+   * @brief Creates an empty window.
+   * @param nr_lines The maximum number of lines in the window.
+   * @param max_depth The maximum depth of the FST (see FST::FST).
+   * @throws invalid_argument If the window cannot hold a line.
+   */
+  SlidingWindowFST(size_t nr_lines,
+                   unsigned int max_depth = FST::UNLIMITED_DEPTH);
+
+  SlidingWindowFST(const SlidingWindowFST &) = delete;
+  SlidingWindowFST &operator=(const SlidingWindowFST &) = delete;
+
+  // --------------------------------------------------
+  // Getters
+  // --------------------------------------------------
+
+  /**
+   * @brief Gets the maximum number of lines in the window.
+   * @return The maximum number of lines.
+   */
+  size_t getCapacity() const { return this->nr_lines; }
+
+  /**
+   * @brief Gets the number of lines currently in the window.
+   * @return The number of lines.
+   */
+  size_t getNrLines() const { return this->lines.size(); }
+
+  /**
+   * @brief Gets the FST of the lines in the window.
+   * @return The FST.
+   */
+  const FST &getFST() const { return this->fst; }
+
+  /**
+   * @brief Gets the dictionary entries of the lines in the window (see
+   * FST::getDictionaryEntries). The selection runs on a copy, the window
+   * stays unchanged.
+   * @param x The number of entries.
+   * @param max_level The maximum level of the entries.
+   * @return The dictionary entries.
+   */
+  list<string> getDictionaryEntries(unsigned int x = 255,
+                                    unsigned int max_level = 7) const;
+
+  // --------------------------------------------------
+  // Stream
+  // --------------------------------------------------
+
+  /**
+   * @brief Appends a line to the window, removing the oldest line once the
+   * window is full.
+   * @param line The line to append.
+   */
+  void addLine(string_view line);
+
+  /**
+   * @brief Removes all lines from the window.
+   */
+  void clear();
+};
+
+#endif
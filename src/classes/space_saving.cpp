@@ -0,0 +1,252 @@
+using namespace std;
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "space_saving.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class SpaceSaving
+// ---------------------------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------------------
+// Private functions
+// -----------------------------------------------------------------------------------------
+
+size_t SpaceSaving::findSlot(uint64_t key, unsigned int length) const
+{
+  // Probe until the counter or an empty slot is found
+  size_t slot = this->getHomeSlot(key, length);
+  while (this->slots[slot] != 0)
+  {
+    const Counter &counter = this->counters[this->slots[slot] - 1];
+    if (counter.key == key && counter.length == length)
+      break;
+    slot = (slot + 1) & this->slot_mask;
+  }
+  return slot;
+}
+
+void SpaceSaving::eraseSlot(size_t slot)
+{
+  // Move every following counter back into the gap unless its home slot lies
+  // (cyclically) after the gap
+  size_t next = slot;
+  while (true)
+  {
+    next = (next + 1) & this->slot_mask;
+    if (this->slots[next] == 0)
+      break;
+
+    const Counter &counter = this->counters[this->slots[next] - 1];
+    size_t home = this->getHomeSlot(counter.key, counter.length);
+    if (((next - home) & this->slot_mask) >= ((next - slot) & this->slot_mask))
+    {
+      this->slots[slot] = this->slots[next];
+      slot = next;
+    }
+  }
+  this->slots[slot] = 0;
+}
+
+void SpaceSaving::siftDown(uint32_t pos)
+{
+  // Move the less frequent children up until the counter has found its place
+  uint32_t counter = this->heap[pos];
+  uint64_t frequency = this->counters[counter].frequency;
+  while (true)
+  {
+    uint32_t child = 2 * pos + 1;
+    if (child >= this->heap.size())
+      break;
+    if (child + 1 < this->heap.size() &&
+        this->counters[this->heap[child + 1]].frequency <
+            this->counters[this->heap[child]].frequency)
+      child++;
+    if (this->counters[this->heap[child]].frequency >= frequency)
+      break;
+
+    this->heap[pos] = this->heap[child];
+    this->heap_positions[this->heap[pos]] = pos;
+    pos = child;
+  }
+  this->heap[pos] = counter;
+  this->heap_positions[counter] = pos;
+}
+
+void SpaceSaving::siftUp(uint32_t pos)
+{
+  // Move the more frequent parents down until the counter has found its place
+  uint32_t counter = this->heap[pos];
+  uint64_t frequency = this->counters[counter].frequency;
+  while (pos > 0)
+  {
+    uint32_t parent = (pos - 1) / 2;
+    if (this->counters[this->heap[parent]].frequency <= frequency)
+      break;
+
+    this->heap[pos] = this->heap[parent];
+    this->heap_positions[this->heap[pos]] = pos;
+    pos = parent;
+  }
+  this->heap[pos] = counter;
+  this->heap_positions[counter] = pos;
+}
+
+void SpaceSaving::count(uint64_t key, size_t end, unsigned int length,
+                        unsigned int weight)
+{
+  size_t slot = this->findSlot(key, length);
+
+  // Count the occurrence of a kept substring
+  if (this->slots[slot] != 0)
+  {
+    uint32_t id = this->slots[slot] - 1;
+    Counter &counter = this->counters[id];
+    counter.frequency += weight;
+
+    // It cannot be replaced if it overlaps the last replaceable occurrence
+    // within the same string
+    if (counter.last_string == this->nr_strings &&
+        end - length < counter.last_end)
+      counter.overlaps += weight;
+    else
+    {
+      counter.last_string = this->nr_strings;
+      counter.last_end = end;
+    }
+
+    this->siftDown(this->heap_positions[id]);
+    return;
+  }
+
+  // Keep a new substring while there is space
+  if (this->counters.size() < this->capacity)
+  {
+    uint32_t id = this->counters.size();
+    this->counters.push_back({key, length, weight, 0, 0,
+                              this->stream_length + end - length,
+                              this->nr_strings, end});
+    this->slots[slot] = id + 1;
+    this->heap.push_back(id);
+    this->heap_positions.push_back(id);
+    this->siftUp(id);
+    return;
+  }
+
+  // Otherwise replace the least frequent substring, which passes its
+  // frequency on as the error of the new one
+  uint32_t id = this->heap[0];
+  Counter &counter = this->counters[id];
+  this->eraseSlot(this->findSlot(counter.key, counter.length));
+  counter.error = counter.frequency;
+  counter.frequency += weight;
+  counter.overlaps = 0;
+  counter.first_position = this->stream_length + end - length;
+  counter.key = key;
+  counter.length = length;
+  counter.last_string = this->nr_strings;
+  counter.last_end = end;
+  this->slots[this->findSlot(key, length)] = id + 1;
+  this->siftDown(0);
+}
+
+// -----------------------------------------------------------------------------------------
+// Public functions
+// -----------------------------------------------------------------------------------------
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+SpaceSaving::SpaceSaving(size_t capacity, unsigned int min_length,
+                         unsigned int max_length)
+    : capacity(capacity), min_length(min_length), max_length(max_length),
+      nr_strings(0), nr_bytes(0), stream_length(0)
+{
+  // At least one substring has to be kept
+  if (capacity == 0 || capacity > UINT32_MAX)
+    throw invalid_argument("SpaceSaving: The capacity has to be between 1 and "
+                           "UINT32_MAX");
+  if (min_length < 2 || min_length > max_length || max_length > MAX_LENGTH)
+    throw invalid_argument("SpaceSaving: The lengths have to be between 2 and " +
+                           to_string(MAX_LENGTH));
+
+  // No bytes have been counted yet
+  memset(this->byte_frequencies, 0, sizeof(this->byte_frequencies));
+  fill(begin(this->byte_first_positions), end(this->byte_first_positions),
+       UINT64_MAX);
+
+  // At most half of the slots are used
+  size_t nr_slots = 1;
+  while (nr_slots < 2 * capacity)
+    nr_slots *= 2;
+  this->slots.assign(nr_slots, 0);
+  this->slot_mask = nr_slots - 1;
+}
+
+// --------------------------------------------------
+// Getters
+// --------------------------------------------------
+
+vector<SpaceSaving::HeavyHitter> SpaceSaving::getHeavyHitters() const
+{
+  // Unpack the kept substrings
+  vector<HeavyHitter> heavy_hitters;
+  heavy_hitters.reserve(this->counters.size());
+  for (const Counter &counter : this->counters)
+  {
+    string substring(counter.length, '\0');
+    for (unsigned int i = 0; i < counter.length; i++)
+      substring[i] = (char)(counter.key >> (8 * i));
+    heavy_hitters.push_back({substring, counter.frequency, counter.overlaps,
+                             counter.error, counter.first_position});
+  }
+
+  // The most frequent first (shorter and smaller substrings first on ties)
+  sort(heavy_hitters.begin(), heavy_hitters.end(),
+       [](const HeavyHitter &a, const HeavyHitter &b)
+       {
+         if (a.frequency != b.frequency)
+           return a.frequency > b.frequency;
+         if (a.substring.length() != b.substring.length())
+           return a.substring.length() < b.substring.length();
+         return a.substring < b.substring;
+       });
+  return heavy_hitters;
+}
+
+// --------------------------------------------------
+// Adders
+// --------------------------------------------------
+
+void SpaceSaving::addString(string_view str, unsigned int weight)
+{
+  // The occurrences of a new string do not overlap those of the last one
+  this->nr_strings++;
+  this->nr_bytes += (uint64_t)str.length() * weight;
+
+  // Count every substring starting at the i-th character (its key is
+  // extended by one byte per length)
+  for (size_t i = 0; i < str.length(); i++)
+  {
+    this->byte_frequencies[(unsigned char)str[i]] += weight;
+    this->byte_first_positions[(unsigned char)str[i]] =
+        min(this->byte_first_positions[(unsigned char)str[i]],
+            this->stream_length + i);
+
+    uint64_t key = (unsigned char)str[i];
+    for (unsigned int length = 2;
+         length <= this->max_length && i + length <= str.length(); length++)
+    {
+      key |= (uint64_t)(unsigned char)str[i + length - 1] << (8 * (length - 1));
+      if (length >= this->min_length)
+        this->count(key, i + length, length, weight);
+    }
+  }
+  this->stream_length += str.length();
+}
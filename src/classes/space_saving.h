@@ -0,0 +1,270 @@
+#ifndef SPACE_SAVING_H
+#define SPACE_SAVING_H
+
+using namespace std;
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ---------------------------------------------------------------------------------------------
+// Class SpaceSaving
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @class SpaceSaving
+ * @brief Streaming counter of the most frequent substrings (Space-Saving).
+ *
+ * Every substring of an added string with a length between the minimum and
+ * the maximum length is counted, but at most capacity substrings are kept.
+ * A substring that is not kept replaces the one with the lowest count and
+ * takes over its count as its error. Hence, the memory is bounded by the
+ * capacity while every kept count overestimates the real frequency by at most
+ * its error (which is at most the number of counted occurrences divided by
+ * the capacity), and every substring occurring more often than that is kept.
+ *
+ * Like in the FST, an occurrence overlapping the last replaceable occurrence
+ * of the same substring within a string is counted as an overlap. The single
+ * bytes are counted exactly.
+ */
+class SpaceSaving
+{
+public:
+  /**
+   * @brief The maximum length of the counted substrings (the length of a
+   * FSST symbol).
+   */
+  static constexpr unsigned int MAX_LENGTH = 8;
+
+  /**
+   * @struct HeavyHitter
+   * @brief A kept substring with its estimated number of occurrences.
+   */
+  struct HeavyHitter
+  {
+    string substring;
+    uint64_t frequency; // overestimates the real frequency by at most error
+    uint64_t overlaps;
+    uint64_t error;
+    uint64_t first_position; // of the first counted occurrence in the stream
+  };
+
+private:
+  /**
+   * @struct Counter
+   * @brief A kept substring (its bytes packed into an integer, the first
+   * byte lowest) and its counts.
+   */
+  struct Counter
+  {
+    uint64_t key;
+    unsigned int length;
+    uint64_t frequency;
+    uint64_t overlaps;
+    uint64_t error;
+    uint64_t first_position; // the start of the first counted occurrence
+    uint64_t last_string; // the string of the last replaceable occurrence
+    size_t last_end;      // and its end within that string
+  };
+
+  /**
+   * @brief The maximum number of kept substrings.
+   */
+  size_t capacity;
+
+  /**
+   * @brief The minimum length of the counted substrings.
+   */
+  unsigned int min_length;
+
+  /**
+   * @brief The maximum length of the counted substrings.
+   */
+  unsigned int max_length;
+
+  /**
+   * @brief The kept substrings.
+   */
+  vector<Counter> counters;
+
+  /**
+   * @brief Hash table of the counters by their key and length (open
+   * addressing with linear probing, every slot holds the position of a
+   * counter + 1 or 0 if it is empty). It has at least twice as many slots as
+   * counters, so it is never resized.
+   */
+  vector<uint32_t> slots;
+
+  /**
+   * @brief The number of slots - 1 (a power of two - 1).
+   */
+  size_t slot_mask;
+
+  /**
+   * @brief The counters as a min-heap ordered by their frequency and the
+   * position of every counter within the heap.
+   */
+  vector<uint32_t> heap;
+  vector<uint32_t> heap_positions;
+
+  /**
+   * @brief The exact frequencies of the single bytes.
+   */
+  uint64_t byte_frequencies[256];
+
+  /**
+   * @brief The start of the first occurrence of every byte within the stream
+   * (UINT64_MAX if it did not occur yet).
+   */
+  uint64_t byte_first_positions[256];
+
+  /**
+   * @brief The number of added strings (identifies the current string).
+   */
+  uint64_t nr_strings;
+
+  /**
+   * @brief The number of added bytes.
+   */
+  uint64_t nr_bytes;
+
+  /**
+   * @brief The number of added bytes counted once per string (the start of
+   * the current string within the stream).
+   */
+  uint64_t stream_length;
+
+  /**
+   * @brief Gets the home slot of a substring.
+   * @param key The key of the substring.
+   * @param length The length of the substring.
+   * @return The slot.
+   */
+  size_t getHomeSlot(uint64_t key, unsigned int length) const
+  {
+    return ((key + length) * 0x9E3779B97F4A7C15ULL >> 32) & this->slot_mask;
+  }
+
+  /**
+   * @brief Finds the slot of a substring.
+   * @param key The key of the substring.
+   * @param length The length of the substring.
+   * @return The slot holding its counter or the empty slot to insert it.
+   */
+  size_t findSlot(uint64_t key, unsigned int length) const;
+
+  /**
+   * @brief Empties a slot (moving back the following counters of the probe
+   * sequence, so no tombstones are needed).
+   * @param slot The slot.
+   */
+  void eraseSlot(size_t slot);
+
+  /**
+   * @brief Restores the heap order below a counter whose frequency rose.
+   * @param pos The position of the counter within the heap.
+   */
+  void siftDown(uint32_t pos);
+
+  /**
+   * @brief Restores the heap order above a new counter.
+   * @param pos The position of the counter within the heap.
+   */
+  void siftUp(uint32_t pos);
+
+  /**
+   * @brief Counts an occurrence of a substring.
+   * @param key The key of the substring.
+   * @param end The end of the occurrence within the current string.
+   * @param length The length of the substring.
+   * @param weight The number of times the occurrence is counted.
+   */
+  void count(uint64_t key, size_t end, unsigned int length,
+             unsigned int weight);
+
+public:
+  // --------------------------------------------------
+  // Constructor
+  // --------------------------------------------------
+
+  /**
+   * @brief Creates an empty counter.
+   * @param capacity The maximum number of kept substrings.
+   * @param min_length The minimum length of the counted substrings.
+   * @param max_length The maximum length of the counted substrings.
+   * @throws invalid_argument If no substring can be kept or the lengths are
+   * not between 2 and MAX_LENGTH.
+   */
+  SpaceSaving(size_t capacity, unsigned int min_length = 2,
+              unsigned int max_length = MAX_LENGTH);
+
+  // --------------------------------------------------
+  // Getters
+  // --------------------------------------------------
+
+  /**
+   * @brief Gets the maximum number of kept substrings.
+   * @return The capacity.
+   */
+  size_t getCapacity() const { return this->capacity; }
+
+  /**
+   * @brief Gets the maximum length of the counted substrings.
+   * @return The maximum length.
+   */
+  unsigned int getMaxLength() const { return this->max_length; }
+
+  /**
+   * @brief Gets the number of kept substrings.
+   * @return The number of kept substrings.
+   */
+  size_t getNrHeavyHitters() const { return this->counters.size(); }
+
+  /**
+   * @brief Gets the number of added bytes.
+   * @return The number of bytes.
+   */
+  uint64_t getNrBytes() const { return this->nr_bytes; }
+
+  /**
+   * @brief Gets the exact frequency of a single byte.
+   * @param byte The byte.
+   * @return The frequency.
+   */
+  uint64_t getByteFrequency(unsigned char byte) const
+  {
+    return this->byte_frequencies[byte];
+  }
+
+  /**
+   * @brief Gets the start of the first occurrence of a single byte within
+   * the stream (the added strings one after another, each once).
+   * @param byte The byte.
+   * @return The position or UINT64_MAX if the byte did not occur.
+   */
+  uint64_t getByteFirstPosition(unsigned char byte) const
+  {
+    return this->byte_first_positions[byte];
+  }
+
+  /**
+   * @brief Gets the kept substrings, the most frequent first.
+   * @return The kept substrings with their estimated counts.
+   */
+  vector<HeavyHitter> getHeavyHitters() const;
+
+  // --------------------------------------------------
+  // Adders
+  // --------------------------------------------------
+
+  /**
+   * @brief Counts the substrings of a string.
+   * @param str The string.
+   * @param weight The number of times the string is counted.
+   */
+  void addString(string_view str, unsigned int weight = 1);
+};
+
+#endif
@@ -0,0 +1,118 @@
+using namespace std;
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-local-typedefs"
+#include "../../lib/fsst/paper/sais.hxx"
+#pragma GCC diagnostic pop
+#include "suffix_array.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class SuffixArray
+// ---------------------------------------------------------------------------------------------
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+SuffixArray::SuffixArray(const vector<string_view> &strings,
+                         unsigned int max_length,
+                         const vector<unsigned int> &weights)
+    : weights(weights), max_length(max_length)
+{
+  // Concatenate the strings, each followed by a separator
+  for (unsigned int i = 0; i < strings.size(); i++)
+  {
+    for (char symbol : strings[i])
+    {
+      this->text.push_back((unsigned char)symbol + 1);
+      this->string_ids.push_back(i);
+    }
+    this->string_ends.push_back(this->text.size());
+    this->text.push_back(0);
+    this->string_ids.push_back(i);
+  }
+
+  // Sort the suffixes
+  int n = this->text.size();
+  this->suffixes.resize(n);
+  if (n > 0)
+    saisxx(this->text.begin(), this->suffixes.begin(), n, 257);
+
+  // Compute the longest common prefixes of neighbouring suffixes (Kasai et
+  // al.), never matching a separator
+  vector<int> ranks(n);
+  for (int i = 0; i < n; i++)
+    ranks[this->suffixes[i]] = i;
+
+  this->lcps.assign(n, 0);
+  int h = 0;
+  for (int pos = 0; pos < n; pos++)
+  {
+    if (ranks[pos] == 0)
+    {
+      h = 0;
+      continue;
+    }
+
+    int prev = this->suffixes[ranks[pos] - 1];
+    while (pos + h < n && prev + h < n && this->text[pos + h] != 0 &&
+           this->text[pos + h] == this->text[prev + h])
+      h++;
+
+    this->lcps[ranks[pos]] = min<unsigned int>(h, this->max_length);
+    if (h > 0)
+      h--;
+  }
+}
+
+// --------------------------------------------------
+// Getters
+// --------------------------------------------------
+
+unsigned int SuffixArray::getLength(unsigned int i) const
+{
+  // The suffix ends with its string or at the maximum length
+  int pos = this->suffixes[i];
+  unsigned int length = this->string_ends[this->string_ids[pos]] - pos;
+  return min(length, this->max_length);
+}
+
+unsigned int SuffixArray::getNrOverlaps(unsigned int first, unsigned int last,
+                                        unsigned int length) const
+{
+  // Occurrences can only overlap if a proper suffix of the substring is also
+  // a prefix of it
+  const int *substring = this->text.data() + this->suffixes[first];
+  bool has_border = false;
+  for (unsigned int shift = 1; shift < length && !has_border; shift++)
+    has_border = equal(substring + shift, substring + length, substring);
+  if (!has_border)
+    return 0;
+
+  // Get the occurrences in text order
+  vector<int> positions(this->suffixes.begin() + first,
+                        this->suffixes.begin() + last);
+  sort(positions.begin(), positions.end());
+
+  // Count the occurrences that cannot be replaced from left to right (in every
+  // copy of their string)
+  unsigned int overlaps = 0;
+  int string_id = -1;
+  int next_free = 0;
+  for (int pos : positions)
+  {
+    if (this->string_ids[pos] != string_id || pos >= next_free)
+    {
+      string_id = this->string_ids[pos];
+      next_free = pos + length;
+    }
+    else
+      overlaps += this->getWeight(pos);
+  }
+
+  return overlaps;
+}
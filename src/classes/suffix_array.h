@@ -0,0 +1,149 @@
+#ifndef SUFFIX_ARRAY_H
+#define SUFFIX_ARRAY_H
+
+using namespace std;
+
+#include <climits>
+#include <string_view>
+#include <vector>
+
+// ---------------------------------------------------------------------------------------------
+// Class SuffixArray
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @class SuffixArray
+ * @brief Suffix array (with LCP array) over a set of strings.
+ *
+ * The strings are concatenated with a separator that is smaller than every
+ * symbol, so suffixes never match across the end of their string. Every
+ * suffix is truncated to its string and to a maximum length; in suffix array
+ * order the truncated suffixes are sorted, all empty ones (starting at a
+ * separator) come first. Construction takes linear time (SA-IS and Kasai).
+ */
+class SuffixArray
+{
+private:
+  /**
+   * @brief The concatenated strings (symbol + 1, 0 separates the strings).
+   */
+  std::vector<int> text;
+
+  /**
+   * @brief The start positions of the suffixes in sorted order.
+   */
+  std::vector<int> suffixes;
+
+  /**
+   * @brief lcps[i] is the length of the longest common prefix of the
+   * (truncated) suffixes i - 1 and i (0 for i = 0).
+   */
+  std::vector<int> lcps;
+
+  /**
+   * @brief The index of the string each position belongs to.
+   */
+  std::vector<int> string_ids;
+
+  /**
+   * @brief The end position (exclusive) of each string within the text.
+   */
+  std::vector<int> string_ends;
+
+  /**
+   * @brief The number of copies of every string (empty if every string
+   * occurs once).
+   */
+  std::vector<unsigned int> weights;
+
+  /**
+   * @brief The length the suffixes are truncated to.
+   */
+  unsigned int max_length;
+
+public:
+  // --------------------------------------------------
+  // Constructor
+  // --------------------------------------------------
+
+  /**
+   * @brief Constructs the suffix array over a set of strings.
+   * @param strings The strings (are not referenced after construction).
+   * @param max_length The length the suffixes are truncated to.
+   * @param weights The number of copies of every string (empty if every
+   * string occurs once). Every suffix stands for the suffixes of all copies.
+   */
+  SuffixArray(const vector<string_view> &strings,
+              unsigned int max_length = UINT_MAX,
+              const vector<unsigned int> &weights = {});
+
+  // --------------------------------------------------
+  // Getters
+  // --------------------------------------------------
+
+  /**
+   * @brief Gets the number of suffixes (including the empty ones).
+   * @return The number of suffixes.
+   */
+  unsigned int getNrSuffixes() const { return this->suffixes.size(); }
+
+  /**
+   * @brief Gets the start position of the i-th suffix.
+   * @param i The rank of the suffix.
+   * @return The position within the text.
+   */
+  int getPosition(unsigned int i) const { return this->suffixes[i]; }
+
+  /**
+   * @brief Gets the length of the i-th (truncated) suffix.
+   * @param i The rank of the suffix.
+   * @return The length (0 for suffixes starting at a separator).
+   */
+  unsigned int getLength(unsigned int i) const;
+
+  /**
+   * @brief Gets the length of the longest common prefix of the (truncated)
+   * suffixes i - 1 and i.
+   * @param i The rank of the suffix.
+   * @return The length of the common prefix.
+   */
+  unsigned int getLcp(unsigned int i) const { return this->lcps[i]; }
+
+  /**
+   * @brief Gets the symbol at a position of the text.
+   * @param pos The position.
+   * @return The symbol.
+   */
+  char getSymbol(int pos) const { return (char)(this->text[pos] - 1); }
+
+  /**
+   * @brief Gets the index of the string a position belongs to.
+   * @param pos The position.
+   * @return The index of the string.
+   */
+  int getStringId(int pos) const { return this->string_ids[pos]; }
+
+  /**
+   * @brief Gets the number of copies of the string a position belongs to.
+   * @param pos The position.
+   * @return The number of copies.
+   */
+  unsigned int getWeight(int pos) const
+  {
+    return this->weights.empty() ? 1 : this->weights[this->string_ids[pos]];
+  }
+
+  /**
+   * @brief Gets how many occurrences of a substring cannot be replaced because
+   * they overlap an earlier occurrence in the same string (replacing greedily
+   * from left to right), counting every copy of a string.
+   * @param first The rank of the first suffix starting with the substring.
+   * @param last The rank after the last suffix starting with the substring.
+   * @param length The length of the substring.
+   * @return The number of overlapping occurrences.
+   */
+  unsigned int getNrOverlaps(unsigned int first, unsigned int last,
+                             unsigned int length) const;
+};
+
+#endif
@@ -12,10 +12,15 @@
 #include "fsst.h"
 // END OF MODIFIED
 
+#include <algorithm>
 #include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 #include <iomanip>
@@ -31,6 +36,10 @@ using namespace std;
 // input and output, and two background pthreads for reading and writing. The
 // idea is to make the CPU overlap with I/O.
 //
+// MODIFIED: Instead of double buffering, a bounded ring of blocks is shared by
+// the reader, one worker per core and the writer, so independent blocks are
+// (de)compressed on different cores while the output stays in order.
+//
 // The data format is quite simple. A FSST compressed file is a sequence of
 // blocks, each with format: (1) 3-byte block length field (max blocksize is
 // hence 16MB). This byte-length includes (1), (2) and (3). (2) FSST dictionary
@@ -45,41 +54,48 @@ using namespace std;
 namespace
 {
 
-   class BinarySemaphore
+   // MODIFIED: Replaced the double buffer (and its BinarySemaphores) by a ring
+   // of blocks. The reader fills the free blocks in order, a pool of workers
+   // builds the symbol tables and (de)compresses the blocks in parallel, and the
+   // writer writes the processed blocks out in order and frees them again.
+   enum BlockState
    {
-   private:
-      mutex m;
-      condition_variable cv;
-      bool value;
-
-   public:
-      explicit BinarySemaphore(bool initialValue = false) : value(initialValue) {}
-      void wait()
-      {
-         unique_lock<mutex> lock(m);
-         while (!value)
-            cv.wait(lock);
-         value = false;
-      }
-      void post()
-      {
-         {
-            unique_lock<mutex> lock(m);
-            value = true;
-         }
-         cv.notify_one();
-      }
+      FREE, // may be filled by the reader
+      READ, // ready to be processed by a worker
+      DONE  // ready to be written by the writer
+   };
+
+   struct Block
+   {
+      unsigned char *srcBuf = NULL;
+      unsigned char *dstBuf = NULL;
+      unsigned char *dstMem = NULL;
+      size_t srcLen = 0;
+      size_t dstLen = 0;
+      size_t nr = 0; // position of the block in the stream
+      BlockState state = FREE;
+
+      // Timers of the block (filled by the worker)
+      chrono::duration<double> symbolTableTime{0};
+      chrono::duration<double> compressionTime{0};
+      chrono::high_resolution_clock::time_point compressionStart;
+      chrono::high_resolution_clock::time_point compressionEnd;
    };
 
+   mutex ringMutex;
+   condition_variable ringChanged;
+   vector<Block> ring;
    bool stopThreads = false;
-   BinarySemaphore srcDoneIO[2], dstDoneIO[2], srcDoneCPU[2], dstDoneCPU[2];
-   unsigned char *srcBuf[2] = {NULL, NULL};
-   unsigned char *dstBuf[2] = {NULL, NULL};
-   unsigned char *dstMem[2] = {NULL, NULL};
-   size_t srcLen[2] = {0, 0};
-   size_t dstLen[2] = {0, 0};
+   bool failed = false;
+   size_t nextBlock = 0;          // next block to be taken by a worker
+   size_t lastBlock = SIZE_MAX;   // the empty block marking the end of the input
+   // END OF MODIFIED
 
 #define FSST_MEMBUF (1ULL << 22)
+   // MODIFIED: Every worker adds a block of FSST_MEMBUF * 3 bytes to the ring,
+   // so their number is capped to bound the memory on machines with many cores
+#define FSST_MAX_WORKERS 8
+   // END OF MODIFIED
    int decompress = 0;
    size_t blksz =
        FSST_MEMBUF -
@@ -87,6 +103,25 @@ namespace
         FSST_MAXHEADER /
             2); // block size of compression (max compressed size must fit 3 bytes)
 
+   // MODIFIED: The sampling settings are shared by all workers
+   bool fsst_sampling = false;
+   int number_lines_to_sample = 0;
+   // END OF MODIFIED
+
+   // MODIFIED: In adaptive mode the symbol table of the nearest earlier block
+   // is reused as long as it compresses a probe of the new block about as
+   // well as the block it was built for. The blocks take their turn to decide
+   // in stream order (a block waits until the previous one has reused or
+   // built its table), so the output does not depend on the timing of the
+   // workers. Only the compression runs in parallel to the decisions.
+   bool adaptive = false;
+   double max_drift = 0.1;               // tolerated rise of the probe ratio
+   fsst_encoder_t *tableEncoder = NULL;  // the table reused across blocks
+   double tableRatio = 0;                // its probe ratio on its own block
+   size_t tableTurn = 0;                 // the next block to decide
+   size_t tablesBuilt = 0;               // number of tables built
+   // END OF MODIFIED
+
 #define DESERIALIZE(p)                                                          \
    (((unsigned long long)(p)[0]) << 16) | (((unsigned long long)(p)[1]) << 8) | \
        ((unsigned long long)(p)[2])
@@ -99,42 +134,239 @@ namespace
 
    void reader(ifstream &src)
    {
-      for (int swap = 0; true; swap = 1 - swap)
+      for (size_t nr = 0; true; nr++)
       {
-         srcDoneCPU[swap].wait();
-         if (stopThreads)
-            break;
-         src.read((char *)srcBuf[swap], blksz);
-         srcLen[swap] = (unsigned long)src.gcount();
+         Block &block = ring[nr % ring.size()];
+         {
+            unique_lock<mutex> lock(ringMutex);
+            ringChanged.wait(lock, [&]
+                             { return block.state == FREE || stopThreads; });
+            if (stopThreads)
+               break;
+         }
+         src.read((char *)block.srcBuf, blksz);
+         block.srcLen = (unsigned long)src.gcount();
          if (decompress)
          {
-            if (blksz && srcLen[swap] == blksz)
+            if (blksz && block.srcLen == blksz)
             {
                blksz =
-                   DESERIALIZE(srcBuf[swap] + blksz - 3); // read size of next block
-               srcLen[swap] -= 3;                         // cut off size bytes
+                   DESERIALIZE(block.srcBuf + blksz - 3); // read size of next block
+               block.srcLen -= 3;                         // cut off size bytes
             }
             else
             {
                blksz = 0;
             }
          }
-         srcDoneIO[swap].post();
+         {
+            unique_lock<mutex> lock(ringMutex);
+            block.nr = nr;
+            block.state = READ;
+            if (block.srcLen == 0)
+               lastBlock = nr;
+         }
+         ringChanged.notify_all();
+         if (block.srcLen == 0)
+            break;
+      }
+   }
+
+   // MODIFIED: (De)compression of a single block, moved out of the main loop
+   // to be run by the workers
+   bool process(Block &block)
+   {
+      if (decompress)
+      {
+         fsst_decoder_t decoder;
+         size_t hdr = fsst_import(&decoder, block.srcBuf);
+         block.dstLen =
+             fsst_decompress(&decoder, block.srcLen - hdr, block.srcBuf + hdr,
+                             FSST_MEMBUF, block.dstBuf = block.dstMem);
+         return true;
+      }
+
+      unsigned char tmp[FSST_MAXHEADER];
+      fsst_encoder_t *encoder = NULL;
+
+      auto symbol_table_start = chrono::high_resolution_clock::now();
+
+      // MODIFIED: Wait for the turn of the block and try to reuse the table
+      // of the previous one (the encoder is duplicated, the workers share the
+      // table)
+      if (adaptive)
+      {
+         double ratio = 0;
+         {
+            unique_lock<mutex> lock(ringMutex);
+            ringChanged.wait(lock, [&]
+                             { return tableTurn == block.nr || stopThreads; });
+            if (stopThreads)
+               return false;
+            if (tableEncoder != NULL)
+            {
+               encoder = fsst_duplicate(tableEncoder);
+               ratio = tableRatio;
+            }
+         }
+         if (encoder != NULL &&
+             fsst_probe_compression_ratio(encoder, block.srcLen, block.srcBuf) >
+                 ratio * (1 + max_drift))
+         {
+            fsst_destroy(encoder);
+            encoder = NULL;
+         }
+
+         // The next block may decide once this one reuses the table
+         if (encoder != NULL)
+         {
+            {
+               unique_lock<mutex> lock(ringMutex);
+               tableTurn++;
+            }
+            ringChanged.notify_all();
+         }
+      }
+
+      if (encoder == NULL)
+      {
+         // The workers already run one per core, so every worker builds its
+         // FST on a single thread
+         if (!fsst_sampling)
+         {
+            encoder = fsst_create_with_fst(number_lines_to_sample, &block.srcLen, &block.srcBuf,
+                                           UINT_MAX, FST::SUFFIX_TRIE, NULL,
+                                           RESERVOIR_SAMPLING, DEFAULT_SAMPLING_SEED, 1);
+         }
+         else
+         {
+            encoder = fsst_create_with_fst_w_fsst_sampling(1, &block.srcLen, &block.srcBuf, 0,
+                                                           UINT_MAX, FST::SUFFIX_TRIE, NULL, 1);
+         }
+
+         // The new table replaces the previous one for the following blocks,
+         // which may decide from now on
+         fsst_encoder_t *candidate = NULL;
+         double ratio = 0;
+         if (adaptive)
+         {
+            candidate = fsst_duplicate(encoder);
+            ratio = fsst_probe_compression_ratio(encoder, block.srcLen, block.srcBuf);
+         }
+         {
+            unique_lock<mutex> lock(ringMutex);
+            tablesBuilt++;
+            if (candidate != NULL)
+            {
+               swap(tableEncoder, candidate);
+               tableRatio = ratio;
+               tableTurn++;
+            }
+         }
+         ringChanged.notify_all();
+         if (candidate != NULL)
+            fsst_destroy(candidate);
+      }
+      // END OF MODIFIED
+      block.compressionStart = chrono::high_resolution_clock::now();
+      block.symbolTableTime = block.compressionStart - symbol_table_start;
+
+      size_t hdr = fsst_export(encoder, tmp);
+      if (fsst_compress(encoder, 1, &block.srcLen, &block.srcBuf,
+                        FSST_MEMBUF * 2 - FSST_MAXHEADER - 3,
+                        block.dstMem + FSST_MAXHEADER + 3,
+                        &block.dstLen, &block.dstBuf) < 1)
+      {
+         fsst_destroy(encoder);
+         return false;
+      }
+      block.compressionEnd = chrono::high_resolution_clock::now();
+      block.compressionTime = block.compressionEnd - block.compressionStart;
+
+      block.dstLen += 3 + hdr;
+      block.dstBuf -= 3 + hdr;
+      SERIALIZE(block.dstLen, block.dstBuf); // block starts with size
+      copy(tmp, tmp + hdr,
+           block.dstBuf + 3); // then the header (followed by the compressed
+                              // bytes which are already there)
+      fsst_destroy(encoder);
+      return true;
+   }
+
+   void worker()
+   {
+      while (true)
+      {
+         // Take the next block in the stream
+         Block *block;
+         {
+            unique_lock<mutex> lock(ringMutex);
+            size_t nr = nextBlock++;
+            block = &ring[nr % ring.size()];
+            ringChanged.wait(lock, [&]
+                             { return (block->state == READ && block->nr == nr) ||
+                                      nr > lastBlock || stopThreads; });
+            if (nr > lastBlock || stopThreads)
+               break;
+         }
+
+         // The empty block at the end is passed on to stop the writer
+         bool ok = block->srcLen == 0 || process(*block);
+         {
+            unique_lock<mutex> lock(ringMutex);
+            block->state = DONE;
+            if (!ok)
+               failed = stopThreads = true;
+         }
+         ringChanged.notify_all();
       }
    }
+   // END OF MODIFIED
 
-   void writer(ofstream &dst)
+   void writer(ofstream &dst, size_t &srcTot, size_t &dstTot,
+               chrono::duration<double> &symbolTableTime,
+               chrono::duration<double> &compressionTime,
+               chrono::high_resolution_clock::time_point &compressionStart,
+               chrono::high_resolution_clock::time_point &compressionEnd)
    {
-      for (int swap = 0; true; swap = 1 - swap)
+      for (size_t nr = 0; true; nr++)
       {
-         dstDoneCPU[swap].wait();
-         if (!dstLen[swap])
+         Block &block = ring[nr % ring.size()];
+         {
+            unique_lock<mutex> lock(ringMutex);
+            ringChanged.wait(lock, [&]
+                             { return (block.state == DONE && block.nr == nr) ||
+                                      stopThreads; });
+            if (stopThreads)
+               break;
+         }
+         if (block.srcLen == 0)
             break;
-         dst.write((char *)dstBuf[swap], dstLen[swap]);
-         dstDoneIO[swap].post();
+         dst.write((char *)block.dstBuf, block.dstLen);
+
+         // MODIFIED: Sum up the timers of all blocks
+         srcTot += block.srcLen;
+         dstTot += block.dstLen;
+         symbolTableTime += block.symbolTableTime;
+         compressionTime += block.compressionTime;
+         if (nr == 0)
+            compressionStart = block.compressionStart;
+         compressionEnd = block.compressionEnd;
+         // END OF MODIFIED
+
+         {
+            unique_lock<mutex> lock(ringMutex);
+            block.state = FREE;
+         }
+         ringChanged.notify_all();
       }
-      for (int swap = 0; swap < 2; swap++)
-         dstDoneIO[swap].post();
+
+      // Stop the reader and the workers still waiting for input
+      {
+         unique_lock<mutex> lock(ringMutex);
+         stopThreads = true;
+      }
+      ringChanged.notify_all();
    }
 
 } // namespace
@@ -142,9 +374,11 @@ namespace
 int main(int argc, char *argv[])
 {
    // MODIFIED: Added the timer for measuring the compression time
+   // (the times of the symbol table creation and the compression are summed
+   // up over all blocks)
    auto start = std::chrono::high_resolution_clock::now();
-   auto symbol_table_start = std::chrono::high_resolution_clock::now();
-   auto symbol_table_end = std::chrono::high_resolution_clock::now();
+   std::chrono::duration<double> symbol_table_diff{0};
+   std::chrono::duration<double> compression_diff{0};
    auto compression_start = std::chrono::high_resolution_clock::now();
    auto compression_end = std::chrono::high_resolution_clock::now();
    // END OF MODIFIED
@@ -152,22 +386,47 @@ int main(int argc, char *argv[])
    // MODIFIED: Added an additional input to define the number lines to sample
    size_t srcTot = 0, dstTot = 0;
 
-   if (argc < 2 || argc > 5 ||
-       (argc == 5 && (argv[1][0] != '-' || argv[1][1] != 'd' || argv[1][2])) ||
-       (argc == 4 && (argv[1][0] == '-' && argv[1][1] == 'd')))
+   // MODIFIED: Decompression takes "-d infile outfile" as in the usage (the
+   // flag was previously only accepted together with a fourth argument and
+   // then taken as the input file)
+   // MODIFIED: "-a[drift]" before the sampling argument enables the adaptive
+   // reuse of symbol tables across blocks
+   char *program = argv[0];
+   if (argc > 1 && string(argv[1]).rfind("-a", 0) == 0)
    {
-      cerr << "usage: " << argv[0] << " -d infile outfile" << endl;
-      cerr << "       " << argv[0] << " ['fsst' for fsst_sampling or '[pos. int]' for number of lines to sample] infile" << endl;
-      cerr << "       " << argv[0] << " ['fsst' for fsst_sampling or '[pos. int]' for number of lines to sample] infile outfile" << endl;
+      adaptive = true;
+      if (argv[1][2] != '\0')
+      {
+         char *end;
+         max_drift = strtod(argv[1] + 2, &end);
+         if (*end != '\0' || !(max_drift >= 0))
+         {
+            cerr << "Invalid drift. Must be a non-negative number (e.g. -a0.1)." << endl;
+            return -1;
+         }
+      }
+      argv++;
+      argc--;
+   }
+   // END OF MODIFIED
+
+   bool decompress_flag = argc > 1 && string(argv[1]) == "-d";
+   if (argc < 2 || argc > 4 || (decompress_flag && (argc != 4 || adaptive)))
+   {
+      cerr << "usage: " << program << " -d infile outfile" << endl;
+      cerr << "       " << program << " [-a[drift]] ['fsst' for fsst_sampling or '[pos. int]' for number of lines to sample] infile" << endl;
+      cerr << "       " << program << " [-a[drift]] ['fsst' for fsst_sampling or '[pos. int]' for number of lines to sample] infile outfile" << endl;
       return -1;
    }
 
-   bool decompress = (argc == 5);
-   bool fsst_sampling = false;
+   decompress = decompress_flag;
    int argOffset = 1;
-   int number_lines_to_sample = 0;
 
-   if (!decompress)
+   if (decompress)
+   {
+      argOffset = 2;
+   }
+   else
    {
       string firstArg = argv[1];
       if (firstArg == "fsst")
@@ -223,110 +482,54 @@ int main(int argc, char *argv[])
       }
       blksz = DESERIALIZE(tmp); // read first block size
    }
-   vector<unsigned char> buffer(FSST_MEMBUF * 6);
-   srcBuf[0] = buffer.data();
-   srcBuf[1] = srcBuf[0] + (FSST_MEMBUF * (1ULL + decompress));
-   dstMem[0] = srcBuf[1] + (FSST_MEMBUF * (1ULL + decompress));
-   dstMem[1] = dstMem[0] + (FSST_MEMBUF * (2ULL - decompress));
-
-   for (int swap = 0; swap < 2; swap++)
+   // MODIFIED: One worker per core (at most FSST_MAX_WORKERS) and a ring with
+   // a block for each worker, the reader and the writer. The buffers are
+   // always written before they are read, so they are not zero-filled.
+   unsigned int nr_workers =
+       min(max(1u, thread::hardware_concurrency()), (unsigned int)FSST_MAX_WORKERS);
+   ring.resize(nr_workers + 2);
+   unique_ptr<unsigned char[]> buffer(
+       new unsigned char[FSST_MEMBUF * 3 * ring.size()]);
+   for (size_t i = 0; i < ring.size(); i++)
    {
-      srcDoneCPU[swap].post(); // input buffer is not being processed initially
-      dstDoneIO[swap].post();  // output buffer is not being written initially
+      ring[i].srcBuf = buffer.get() + FSST_MEMBUF * 3 * i;
+      ring[i].dstMem = ring[i].srcBuf + (FSST_MEMBUF * (1ULL + decompress));
    }
+
    thread readerThread([&src]
                        { reader(src); });
-   thread writerThread([&dst]
-                       { writer(dst); });
-
-   for (int swap = 0; true; swap = 1 - swap)
-   {
-      srcDoneIO[swap]
-          .wait(); // wait until input buffer is available (i.e. done reading)
-      dstDoneIO[swap]
-          .wait(); // wait until output buffer is ready writing hence free for use
-      if (srcLen[swap] == 0)
-      {
-         dstLen[swap] = 0;
-         break;
-      }
-      if (decompress)
-      {
-         fsst_decoder_t decoder;
-         size_t hdr = fsst_import(&decoder, srcBuf[swap]);
-         dstLen[swap] =
-             fsst_decompress(&decoder, srcLen[swap] - hdr, srcBuf[swap] + hdr,
-                             FSST_MEMBUF, dstBuf[swap] = dstMem[swap]);
-      }
-      else
-      {
-         unsigned char tmp[FSST_MAXHEADER];
+   thread writerThread([&]
+                       { writer(dst, srcTot, dstTot, symbol_table_diff,
+                                compression_diff, compression_start,
+                                compression_end); });
+   vector<thread> workerThreads;
+   for (unsigned int i = 0; i < nr_workers; i++)
+      workerThreads.emplace_back(worker);
 
-         // MODIFIED: Use of our function fsst_create_with_fst instead of the
-         fsst_encoder_t *encoder;
-
-         symbol_table_start = std::chrono::high_resolution_clock::now();
-         if (!fsst_sampling)
-         {
-            encoder = fsst_create_with_fst(number_lines_to_sample, &srcBuf[swap]);
-         }
-         else
-         {
-            encoder = fsst_create_with_fst_w_fsst_sampling(1, &srcLen[swap], &srcBuf[swap], 0);
-         }
-         symbol_table_end = std::chrono::high_resolution_clock::now();
-         // END OF MODIFIED
+   // wait until all blocks are written
+   writerThread.join();
+   readerThread.join();
+   for (thread &workerThread : workerThreads)
+      workerThread.join();
+   if (tableEncoder != NULL)
+      fsst_destroy(tableEncoder);
+   if (failed)
+      return -1;
+   // END OF MODIFIED
 
-         // MODIFIED: Added a timer for measuring the compression time
-         compression_start = std::chrono::high_resolution_clock::now();
-         // END OF MODIFIED
-         size_t hdr = fsst_export(encoder, tmp);
-         if (fsst_compress(encoder, 1, &srcLen[swap], &srcBuf[swap],
-                           FSST_MEMBUF * 2, dstMem[swap] + FSST_MAXHEADER + 3,
-                           &dstLen[swap], &dstBuf[swap]) < 1)
-            return -1;
-         // MODIFIED: Added a timer for measuring the compression time
-         compression_end = std::chrono::high_resolution_clock::now();
-         // END OF MODIFIED
-         dstLen[swap] += 3 + hdr;
-         dstBuf[swap] -= 3 + hdr;
-         SERIALIZE(dstLen[swap], dstBuf[swap]); // block starts with size
-         copy(tmp, tmp + hdr,
-              dstBuf[swap] + 3); // then the header (followed by the compressed
-                                 // bytes which are already there)
-         fsst_destroy(encoder);
-      }
-      srcTot += srcLen[swap];
-      dstTot += dstLen[swap];
-      srcDoneCPU[swap]
-          .post();             // input buffer may be re-used by the reader for the next block
-      dstDoneCPU[swap].post(); // output buffer is ready for writing out
-   }
    cerr << (decompress ? "Dec" : "C") << "ompressed " << srcTot << " bytes into "
         << dstTot << " bytes ==> " << (int)((100 * dstTot) / srcTot) << "%"
         << endl;
 
-   // force wait until all background writes finished
-   stopThreads = true;
-   for (int swap = 0; swap < 2; swap++)
-   {
-      srcDoneCPU[swap].post();
-      dstDoneCPU[swap].post();
-   }
-   dstDoneIO[0].wait();
-   dstDoneIO[1].wait();
-   readerThread.join();
-   writerThread.join();
-
    // MODIFIED: Added the timer for measuring the compression time
    auto end = std::chrono::high_resolution_clock::now();
    std::chrono::duration<double> diff = end - start;
    std::cout << std::fixed << std::setprecision(6);
    std::cout << "Time to compress: " << diff.count() << " s\n";
-   std::chrono::duration<double> symbol_table_diff = symbol_table_end - symbol_table_start;
    std::cout << "Time to create symbol table: " << symbol_table_diff.count() << " s\n";
-   std::chrono::duration<double> compression_diff = compression_end - compression_start;
    std::cout << "Time to compress (without symbol table creation): " << compression_diff.count() << " s\n";
+   if (adaptive)
+      std::cout << "Symbol tables built: " << tablesBuilt << "\n";
    std::cout << "Start of compression: " << std::chrono::duration_cast<std::chrono::milliseconds>(compression_start.time_since_epoch()).count() << " ms\n";
    std::cout << "End of compression: " << std::chrono::duration_cast<std::chrono::milliseconds>(compression_end.time_since_epoch()).count() << " ms\n";
    // END OF MODIFIED
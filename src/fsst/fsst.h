@@ -1,19 +1,122 @@
 #ifndef FSST_WITH_FST_INCLUDED_H
 #define FSST_WITH_FST_INCLUDED_H
 
+#include <climits>
+
 #include "../../lib/fsst/libfsst.hpp"
+#include "../classes/fst.h"
+#include "sampling.h"
 
 /**
  * @brief Calibrate a FSST symbol table from a batch of strings.
- * @param n_samples The number of strings in the batch to sample from.
+ * @param n_samples The number of lines to sample from the batch.
+ * @param lenIn The length of the batch (it may contain zero bytes).
+ * @param strIn The start of the batch (lines separated by newlines).
+ * @param max_depth The maximum level of the nodes in the FST (UINT_MAX to
+ * insert all suffixes completely).
+ * @param backend The backend counting the substrings of the sample.
+ * @param gain_model The model ranking the dictionary entries (NULL for the
+ * default model).
+ * @param sampling The way the lines are sampled.
+ * @param seed The seed of the sampling (equal seeds draw equal samples).
+ * @param nr_threads The maximum number of threads building the FST (0 to use
+ * one per hardware thread, 1 if the caller already runs one per core).
+ * @return A pointer to the created FSST encoder.
+ */
+fsst_encoder_t *fsst_create_with_fst(size_t n_samples, size_t lenIn[],
+                                     unsigned char *strIn[],
+                                     unsigned int max_depth = UINT_MAX,
+                                     FST::CountingBackend backend = FST::SUFFIX_TRIE,
+                                     const GainModel *gain_model = NULL,
+                                     SamplingMode sampling = RESERVOIR_SAMPLING,
+                                     uint64_t seed = DEFAULT_SAMPLING_SEED,
+                                     unsigned int nr_threads = 0);
+
+/**
+ * @brief Calibrate a FSST symbol table from a batch of strings like
+ * fsst_create (the FST is built from the strings in place, sampling about as
+ * many bytes as FSST does).
+ * @param n The number of strings in the batch.
+ * @param lenIn The byte-lengths of the strings.
  * @param strIn The string start pointers.
+ * @param zeroTerminated Whether the strings are zero-terminated (the
+ * terminating zero byte is not added to the FST).
+ * @param max_depth The maximum level of the nodes in the FST (UINT_MAX to
+ * insert all suffixes completely).
+ * @param backend The backend counting the substrings of the sample.
+ * @param gain_model The model ranking the dictionary entries (NULL for the
+ * default model).
+ * @param nr_threads The maximum number of threads building the FST (0 to use
+ * one per hardware thread).
  * @return A pointer to the created FSST encoder.
  */
-fsst_encoder_t *fsst_create_with_fst(size_t n_samples, unsigned char *strIn[]);
+fsst_encoder_t *fsst_create_with_fst_from_strings(size_t n, size_t lenIn[],
+                                                  unsigned char *strIn[],
+                                                  int zeroTerminated,
+                                                  unsigned int max_depth = UINT_MAX,
+                                                  FST::CountingBackend backend = FST::SUFFIX_TRIE,
+                                                  const GainModel *gain_model = NULL,
+                                                  unsigned int nr_threads = 0);
+
+/**
+ * @brief Build a FSST symbol table from the dictionary entries of an FST and
+ * its uncovered bytes, ranked by the bytes they save (the FST is deleted).
+ * @param fstc The FST of the sample.
+ * @param byte_histo The frequencies of the bytes of the sample (the least
+ * frequent byte terminates strings that are not zero-terminated).
+ * @param zeroTerminated Whether the strings to compress are zero-terminated.
+ * @return A pointer to the created FSST encoder.
+ */
+fsst_encoder_t *create_encoder_from_fst(FST *fstc, const u64 byte_histo[256],
+                                        int zeroTerminated);
+
+/**
+ * @brief Calibrate a FSST symbol table from the substrings a SpaceSaving
+ * counter kept (e.g. after streaming a whole file through it line by line,
+ * so the memory stays bounded by the capacity of the counter).
+ * @param counter The counter.
+ * @param zeroTerminated Whether the strings to compress are zero-terminated.
+ * @param gain_model The model ranking the dictionary entries (NULL for the
+ * default model).
+ * @return A pointer to the created FSST encoder.
+ */
+fsst_encoder_t *fsst_create_with_space_saving(const SpaceSaving &counter,
+                                              int zeroTerminated,
+                                              const GainModel *gain_model = NULL);
+
+/**
+ * @brief The number of bytes probed to estimate how well a symbol table
+ * compresses a batch.
+ */
+constexpr size_t FSST_PROBE_BYTES = 1 << 12;
+
+/**
+ * @brief Estimate how well an encoder compresses a batch by compressing a
+ * small sample of its lines (e.g. to check whether the symbol table of a
+ * previous batch still fits).
+ * @param encoder The encoder.
+ * @param lenIn The length of the batch.
+ * @param strIn The start of the batch (lines separated by newlines).
+ * @param probe_bytes The number of bytes to sample.
+ * @return The compressed size of the sample divided by its size (0 if the
+ * sample is empty).
+ */
+double fsst_probe_compression_ratio(fsst_encoder_t *encoder, size_t lenIn,
+                                    unsigned char *strIn,
+                                    size_t probe_bytes = FSST_PROBE_BYTES);
 
 /**
  * Tries to mimic the original fsst_create function
+ * (max_depth is the maximum level of the nodes in the FST, UINT_MAX to insert
+ * all suffixes completely; backend counts the substrings of the sample;
+ * gain_model ranks the dictionary entries, NULL for the default model;
+ * nr_threads is the maximum number of threads building the FST, 0 to use one
+ * per hardware thread)
  */
-fsst_encoder_t *fsst_create_with_fst_w_fsst_sampling(size_t n, size_t lenIn[], u8 *strIn[], int zeroTerminated);
+fsst_encoder_t *fsst_create_with_fst_w_fsst_sampling(size_t n, size_t lenIn[], u8 *strIn[], int zeroTerminated,
+                                                     unsigned int max_depth = UINT_MAX,
+                                                     FST::CountingBackend backend = FST::SUFFIX_TRIE,
+                                                     const GainModel *gain_model = NULL,
+                                                     unsigned int nr_threads = 0);
 
 #endif
\ No newline at end of file
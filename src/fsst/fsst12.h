@@ -0,0 +1,33 @@
+#ifndef FSST12_WITH_FST_INCLUDED_H
+#define FSST12_WITH_FST_INCLUDED_H
+
+#include <climits>
+
+#include "../../lib/fsst/fsst12.h"
+#include "../classes/fst.h"
+#include "sampling.h"
+
+/**
+ * @brief Calibrate a FSST12 symbol map (up to 4096 codes of 12 bits) from a
+ * batch of strings like fsst_create of libfsst12 (the FST is built from the
+ * strings in place, sampling about as many bytes as FSST12 does).
+ * @param n The number of strings in the batch.
+ * @param lenIn The byte-lengths of the strings.
+ * @param strIn The string start pointers.
+ * @param zeroTerminated Whether the strings are zero-terminated (the
+ * terminating zero byte is not added to the FST).
+ * @param max_depth The maximum level of the nodes in the FST (UINT_MAX to
+ * insert all suffixes completely).
+ * @param backend The backend counting the substrings of the sample.
+ * @param gain_model The model ranking the dictionary entries (NULL for a
+ * CodeGainModel with 12-bit codes).
+ * @return A pointer to the created FSST12 encoder.
+ */
+fsst_encoder_t *fsst12_create_with_fst(size_t n, size_t lenIn[],
+                                       unsigned char *strIn[],
+                                       int zeroTerminated,
+                                       unsigned int max_depth = UINT_MAX,
+                                       FST::CountingBackend backend = FST::SUFFIX_TRIE,
+                                       const GainModel *gain_model = NULL);
+
+#endif
@@ -1,148 +1,263 @@
 #include "../../lib/fsst/libfsst.hpp"
 #include "../classes/node.h"
 #include "../classes/fst.h"
+#include "sampling.h"
 
+#include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <list>
-#include <random>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
-std::list<std::string> split_string_by_newline(const std::string &str)
+std::vector<std::string_view>
+get_first_n_items(const std::vector<std::string_view> &input, size_t n)
 {
-  std::list<std::string> result;
-  std::stringstream ss(str);
-
-  std::string line;
-  while (std::getline(ss, line, '\n'))
-  {
-    result.push_back(line);
-  }
-
-  return result;
+  return std::vector<std::string_view>(
+      input.begin(), input.begin() + std::min(n, input.size()));
 }
 
-std::list<std::string> sample_strings(const std::list<std::string> &input_list,
-                                      size_t x)
+// The byte-budget sample matches the sample of FSST
+static_assert(FSST_SAMPLE_TARGET_BYTES == FSST_SAMPLETARGET,
+              "FSST_SAMPLE_TARGET_BYTES has to match FSST_SAMPLETARGET");
+
+fsst_encoder_t *create_encoder_from_fst(FST *fstc,
+                                        const u64 byte_histo[256],
+                                        int zeroTerminated)
 {
-  std::list<std::string> sampled_list;
-  size_t list_size = input_list.size();
+  // Find 255 dictionary entries (with their replaceable occurrences)
+  std::vector<unsigned int> occurrences;
+  list<string> dict_entries = fstc->getDictionaryEntries(255, 7, &occurrences);
 
-  // Create a random number generator with a seed
-  std::random_device rd;
-  std::mt19937 gen(rd());
+  // The occurrences of the entries were subtracted from the FST, so the root
+  // nodes count the bytes that are not covered by any entry
+  u64 byte_frequencies[256] = {0};
+  for (unsigned int i = 0; i < fstc->getNrPaths(); i++)
+  {
+    Node *root = fstc->getPath(i);
+    byte_frequencies[(u8)root->getSymbol()] = root->getFrequency();
+  }
+  delete fstc;
 
-  // Create a uniform distribution for indices in the range [0, list_size)
-  std::uniform_int_distribution<> dist(0, list_size - 1);
+  // Create a new SymbolTable
+  SymbolTable *symbol_table = new SymbolTable();
 
-  // Iterate x times
-  for (size_t i = 0; i < x; ++i)
+  // Choose the terminator like buildSymbolTable: the zero byte for
+  // zero-terminated strings (its symbol is code 0), otherwise the (lowest)
+  // least frequent byte of the sample
+  symbol_table->zeroTerminated = zeroTerminated;
+  if (zeroTerminated)
+  {
+    symbol_table->terminator = 0;
+    symbol_table->add(Symbol((u8)0, 0));
+  }
+  else
   {
-    // Generate a random index from the uniform distribution
-    size_t random_index = dist(gen);
+    symbol_table->terminator =
+        std::min_element(byte_histo, byte_histo + 256) - byte_histo;
+  }
 
-    // Access the corresponding string in the list
-    std::list<std::string>::const_iterator it = input_list.begin();
-    std::advance(it, random_index);
+  // Rank the candidates by the bytes they save in the sample: an entry saves
+  // all but one byte of each occurrence over coding it byte by byte, a single
+  // byte saves the escape byte of each uncovered occurrence
+  std::vector<std::pair<u64, std::string>> candidates;
+  std::vector<unsigned int>::iterator occurrence = occurrences.begin();
+  for (list<string>::iterator it = dict_entries.begin();
+       it != dict_entries.end(); it++, occurrence++)
+  {
+    // Compression appends the terminator to the strings, so multi-byte
+    // symbols cannot contain it
+    if (it->size() < 2 || it->size() > Symbol::maxLength ||
+        it->find((char)symbol_table->terminator) != string::npos)
+      continue;
 
-    // Add the string to the sampled_list
-    sampled_list.push_back(*it);
+    candidates.emplace_back((u64)*occurrence * (it->size() - 1), *it);
   }
+  for (unsigned int byte = zeroTerminated ? 1 : 0; byte < 256; byte++)
+    if (byte_frequencies[byte] > 0)
+      candidates.emplace_back(byte_frequencies[byte], string(1, (char)byte));
 
-  return sampled_list;
-}
+  // Spend the free codes on the candidates with the highest gain (entries
+  // before single bytes with the same gain)
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const std::pair<u64, std::string> &a,
+                      const std::pair<u64, std::string> &b)
+                   { return a.first > b.first; });
 
-std::list<std::string>
-get_first_n_items(const std::list<std::string> &input_list, size_t n)
-{
-  std::list<std::string> output_list;
-
-  std::list<std::string>::const_iterator it = input_list.begin();
-  for (size_t i = 0; i < n && it != input_list.end(); ++i)
+  // Add the selected candidates to the SymbolTable
+  for (size_t i = 0; i < candidates.size() && symbol_table->nSymbols < 255;
+       i++)
   {
-    output_list.push_back(*it);
-    ++it;
+    const char *begin = candidates[i].second.data();
+    const char *end = candidates[i].second.data() + candidates[i].second.size();
+    symbol_table->add(Symbol(begin, end));
   }
 
-  return output_list;
+  // Renumber the codes for the compression kernels (as buildSymbolTable does)
+  symbol_table->finalize(zeroTerminated);
+
+  // Create a encoder based on our SymbolTable
+  Encoder *encoder = new Encoder();
+  encoder->symbolTable = shared_ptr<SymbolTable>(symbol_table);
+  return (fsst_encoder_t *)encoder;
 }
 
-fsst_encoder_t *fsst_create_with_fst(size_t n_samples, unsigned char *strIn[])
+fsst_encoder_t *create_encoder_with_fst(
+    const std::vector<std::string_view> &sample, int zeroTerminated,
+    unsigned int max_depth, FST::CountingBackend backend,
+    const GainModel *gain_model, unsigned int nr_threads)
 {
-  // Split the input string by newline
-  string str = string((char *)strIn[0]);
-  std::list<std::string> strs = split_string_by_newline(str);
-
   // Make a FST
-  FST *fstc = new FST();
+  FST *fstc = new FST(max_depth);
+  fstc->setGainModel(gain_model);
 
-  // Sample strings from the input list
-  std::list<std::string> sample_strs = sample_strings(strs, n_samples);
+  // Add each distinct sampled string once with its number of samples
+  // (low-cardinality columns repeat the same strings)
+  if (!sample.empty())
+  {
+    std::vector<std::string_view> distinct_strs;
+    std::vector<unsigned int> counts;
+    count_distinct_strings(sample, distinct_strs, counts);
+    fstc->addStrings(distinct_strs, counts, backend, nr_threads);
+  }
 
-  // Add a sample of strings to the FST
-  fstc->addStrings(sample_strs);
+  // Count the bytes of the sample (to choose the terminator)
+  u64 byte_histo[256] = {0};
+  for (std::string_view str : sample)
+    for (char c : str)
+      byte_histo[(u8)c]++;
 
-  // Find 255 dictionary entries
-  list<string> dict_entries = fstc->getDictionaryEntries(255, 7);
+  return create_encoder_from_fst(fstc, byte_histo, zeroTerminated);
+}
 
-  // Create a new SymbolTable
-  SymbolTable *symbol_table = new SymbolTable();
+fsst_encoder_t *fsst_create_with_fst(size_t n_samples, size_t lenIn[],
+                                     unsigned char *strIn[],
+                                     unsigned int max_depth,
+                                     FST::CountingBackend backend,
+                                     const GainModel *gain_model,
+                                     SamplingMode sampling, uint64_t seed,
+                                     unsigned int nr_threads)
+{
+  // Split the input string by newline (the lines point into the input)
+  std::string_view str((const char *)strIn[0], lenIn[0]);
+  std::vector<std::string_view> strs = split_string_by_newline(str);
 
-  // Add the dictionary entries to the SymbolTable
-  for (list<string>::iterator it = dict_entries.begin();
-       it != dict_entries.end(); it++)
+  // Build the encoder from a sample of the lines
+  return create_encoder_with_fst(sample_lines(strs, n_samples, sampling, seed),
+                                 0, max_depth, backend, gain_model, nr_threads);
+}
+
+fsst_encoder_t *fsst_create_with_fst_from_strings(size_t n, size_t lenIn[],
+                                                  u8 *strIn[],
+                                                  int zeroTerminated,
+                                                  unsigned int max_depth,
+                                                  FST::CountingBackend backend,
+                                                  const GainModel *gain_model,
+                                                  unsigned int nr_threads)
+{
+  // Take a view on every string (without the terminating zero byte)
+  std::vector<std::string_view> strs;
+  strs.reserve(n);
+  for (size_t i = 0; i < n; i++)
   {
-    const char *begin = it->data();
-    const char *end = it->data() + it->size();
-    symbol_table->add(Symbol(begin, end));
+    size_t len = lenIn[i];
+    if (zeroTerminated && len > 0 && strIn[i][len - 1] == 0)
+      len--;
+    strs.emplace_back((const char *)strIn[i], len);
   }
 
-  // Create a encoder based on our SymbolTable
-  Encoder *encoder = new Encoder();
-  encoder->symbolTable = shared_ptr<SymbolTable>(symbol_table);
-  return (fsst_encoder_t *)encoder;
+  // Build the encoder from a sample of about as many bytes as FSST samples
+  return create_encoder_with_fst(sample_lines(strs, n, BYTE_BUDGET_SAMPLING),
+                                 zeroTerminated, max_depth, backend,
+                                 gain_model, nr_threads);
 }
 
-fsst_encoder_t *fsst_create_with_fst_w_fsst_sampling(size_t n, size_t lenIn[], u8 *strIn[], int zeroTerminated)
+fsst_encoder_t *fsst_create_with_space_saving(const SpaceSaving &counter,
+                                             int zeroTerminated,
+                                             const GainModel *gain_model)
+{
+  // Make a FST from the most frequent substrings
+  FST *fstc = new FST(counter.getMaxLength() - 1);
+  fstc->setGainModel(gain_model);
+  fstc->addHeavyHitters(counter);
+
+  // The bytes are counted exactly
+  u64 byte_histo[256];
+  for (unsigned int byte = 0; byte < 256; byte++)
+    byte_histo[byte] = counter.getByteFrequency(byte);
+
+  return create_encoder_from_fst(fstc, byte_histo, zeroTerminated);
+}
+
+fsst_encoder_t *fsst_create_with_fst_w_fsst_sampling(size_t n, size_t lenIn[], u8 *strIn[], int zeroTerminated,
+                                                     unsigned int max_depth,
+                                                     FST::CountingBackend backend,
+                                                     const GainModel *gain_model,
+                                                     unsigned int nr_threads)
 {
   // Call makeSample
   u8 *sampleBuf = new u8[FSST_SAMPLEMAXSZ];
   size_t *sampleLen = lenIn;
   std::vector<u8 *> sample = makeSample(sampleBuf, strIn, &sampleLen, n ? n : 1);
 
-  // Transform sample into a list of strings
-  std::list<std::string> sample_strs;
+  // Build the encoder from the sampled strings (in place)
+  std::vector<std::string_view> sample_strs;
   for (size_t i = 0; i < sample.size(); ++i)
-  {
-    std::string str(sample[i], sample[i] + sampleLen[i]);
-    sample_strs.push_back(str);
-  }
+    sample_strs.emplace_back((const char *)sample[i], sampleLen[i]);
+  fsst_encoder_t *encoder =
+      create_encoder_with_fst(sample_strs, zeroTerminated, max_depth, backend,
+                              gain_model, nr_threads);
 
-  // Make a FST
-  FST *fstc = new FST();
+  // The sample is not needed anymore
+  if (sampleLen != lenIn)
+    delete[] sampleLen;
+  delete[] sampleBuf;
 
-  // Add a sample of strings to the FST
-  fstc->addStrings(sample_strs);
-
-  // Find 255 dictionary entries
-  list<string> dict_entries = fstc->getDictionaryEntries(255, 7);
+  return encoder;
+}
 
-  // Create a new SymbolTable
-  SymbolTable *symbol_table = new SymbolTable();
+double fsst_probe_compression_ratio(fsst_encoder_t *encoder, size_t lenIn,
+                                    unsigned char *strIn, size_t probe_bytes)
+{
+  // Probe a sample of the lines (a different seed than the sample the symbol
+  // table is built from, so the table is not judged on its own sample)
+  std::string_view str((const char *)strIn, lenIn);
+  std::vector<std::string_view> probe =
+      sample_lines(split_string_by_newline(str), SIZE_MAX, BYTE_BUDGET_SAMPLING,
+                   DEFAULT_SAMPLING_SEED + 1, probe_bytes);
 
-  // Add the dictionary entries to the SymbolTable
-  for (list<string>::iterator it = dict_entries.begin();
-       it != dict_entries.end(); it++)
+  std::vector<size_t> lens;
+  std::vector<u8 *> strs;
+  size_t probe_len = 0;
+  for (std::string_view line : probe)
   {
-    const char *begin = it->data();
-    const char *end = it->data() + it->size();
-    symbol_table->add(Symbol(begin, end));
+    lens.push_back(line.length());
+    strs.push_back((u8 *)line.data());
+    probe_len += line.length();
   }
+  if (probe_len == 0)
+    return 0;
 
-  // Create a encoder based on our SymbolTable
-  Encoder *encoder = new Encoder();
-  encoder->symbolTable = shared_ptr<SymbolTable>(symbol_table);
-  return (fsst_encoder_t *)encoder;
-}
\ No newline at end of file
+  // Compress the probe (escaping every byte at worst doubles its size)
+  std::vector<u8> output(2 * probe_len + 8);
+  std::vector<size_t> lenOut(probe.size());
+  std::vector<u8 *> strOut(probe.size());
+  size_t compressed = fsst_compress(encoder, probe.size(), lens.data(),
+                                    strs.data(), output.size(), output.data(),
+                                    lenOut.data(), strOut.data());
+
+  // Only the lines that fit into the output are judged
+  size_t compressed_len = 0, uncompressed_len = 0;
+  for (size_t i = 0; i < compressed; i++)
+  {
+    compressed_len += lenOut[i];
+    uncompressed_len += lens[i];
+  }
+  if (uncompressed_len == 0)
+    return 0;
+  return (double)compressed_len / uncompressed_len;
+}
@@ -0,0 +1,74 @@
+#include "../../lib/fsst/libfsst12.hpp"
+#include "../classes/fst.h"
+#include "fsst12.h"
+#include "sampling.h"
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+fsst_encoder_t *fsst12_create_with_fst(size_t n, size_t lenIn[], u8 *strIn[],
+                                       int zeroTerminated,
+                                       unsigned int max_depth,
+                                       FST::CountingBackend backend,
+                                       const GainModel *gain_model)
+{
+  // Take a view on every string (without the terminating zero byte)
+  std::vector<std::string_view> strs;
+  strs.reserve(n);
+  for (size_t i = 0; i < n; i++)
+  {
+    size_t len = lenIn[i];
+    if (zeroTerminated && len > 0 && strIn[i][len - 1] == 0)
+      len--;
+    strs.emplace_back((const char *)strIn[i], len);
+  }
+
+  // Sample about as many bytes as FSST12 does
+  std::vector<std::string_view> sample =
+      sample_lines(strs, n, BYTE_BUDGET_SAMPLING, DEFAULT_SAMPLING_SEED,
+                   FSST12_SAMPLE_TARGET_BYTES);
+
+  // Make a FST, ranking the entries by the bits they save with 12-bit codes
+  static const CodeGainModel code_gain_model(CodeGainModel::FSST12_CODE_WIDTH);
+  FST *fstc = new FST(max_depth);
+  fstc->setGainModel(gain_model != NULL ? gain_model : &code_gain_model);
+
+  // Add each distinct sampled string once with its number of samples
+  if (!sample.empty())
+  {
+    std::vector<std::string_view> distinct_strs;
+    std::vector<unsigned int> counts;
+    count_distinct_strings(sample, distinct_strs, counts);
+    fstc->addStrings(distinct_strs, counts, backend);
+  }
+
+  // Find a dictionary entry for every code that is not a single byte (the
+  // gain heap only updates the nodes that change, so thousands of entries do
+  // not need thousands of full sorts)
+  list<string> dict_entries = fstc->getDictionaryEntries(4096 - 256, 7);
+  delete fstc;
+
+  // Create a new SymbolMap (the first 256 codes are the single bytes)
+  SymbolMap *symbol_map = new SymbolMap();
+  symbol_map->zeroTerminated = zeroTerminated;
+
+  // Add the dictionary entries to the SymbolMap (entries colliding in its hash
+  // table are left out like in buildSymbolMap)
+  for (list<string>::iterator it = dict_entries.begin();
+       it != dict_entries.end() && symbol_map->symbolCount < 4096; it++)
+  {
+    if (it->size() < 2 || it->size() > Symbol::maxLength)
+      continue;
+
+    const char *begin = it->data();
+    const char *end = it->data() + it->size();
+    symbol_map->add(Symbol(begin, end));
+  }
+
+  // Create a encoder based on our SymbolMap
+  Encoder *encoder = new Encoder();
+  encoder->symbolMap = shared_ptr<SymbolMap>(symbol_map);
+  return (fsst_encoder_t *)encoder;
+}
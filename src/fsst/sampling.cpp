@@ -0,0 +1,167 @@
+#include "sampling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+std::vector<std::string_view> split_string_by_newline(std::string_view str)
+{
+  std::vector<std::string_view> result;
+  const char *data = str.data();
+  size_t begin = 0;
+
+  // Take a view on the line ending at a newline
+  auto add_line = [&](size_t end)
+  {
+    result.emplace_back(data + begin, end - begin);
+    begin = end + 1;
+  };
+
+  // Find the newlines of a block of bytes at once, going through the bits of
+  // the comparison mask
+  size_t pos = 0;
+#if defined(__AVX2__)
+  const __m256i newlines_256 = _mm256_set1_epi8('\n');
+  for (; pos + 32 <= str.size(); pos += 32)
+  {
+    __m256i bytes = _mm256_loadu_si256((const __m256i *)(data + pos));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(bytes, newlines_256));
+    for (; mask != 0; mask &= mask - 1)
+      add_line(pos + __builtin_ctz(mask));
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i newlines_128 = _mm_set1_epi8('\n');
+  for (; pos + 16 <= str.size(); pos += 16)
+  {
+    __m128i bytes = _mm_loadu_si128((const __m128i *)(data + pos));
+    uint32_t mask =
+        (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newlines_128));
+    for (; mask != 0; mask &= mask - 1)
+      add_line(pos + __builtin_ctz(mask));
+  }
+#endif
+
+  // Search the rest byte by byte
+  for (; pos < str.size(); pos++)
+    if (data[pos] == '\n')
+      add_line(pos);
+
+  // The last line does not need a newline (a trailing newline does not start
+  // a new line)
+  if (begin < str.size())
+    add_line(str.size());
+
+  return result;
+}
+
+std::vector<std::string_view>
+sample_lines(const std::vector<std::string_view> &lines, size_t n_samples,
+             SamplingMode sampling, uint64_t seed, size_t target_bytes)
+{
+  // Take all lines if there are not more than to sample
+  if (n_samples >= lines.size() && sampling != BYTE_BUDGET_SAMPLING)
+    return lines;
+
+  std::vector<std::string_view> sampled;
+  std::mt19937_64 gen(seed);
+
+  if (sampling == RESERVOIR_SAMPLING)
+  {
+    // Fill the reservoir with the first lines
+    sampled.assign(lines.begin(), lines.begin() + n_samples);
+    if (n_samples == 0)
+      return sampled;
+
+    // Draw a uniform number in (0, 1]
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto random = [&]()
+    { return 1.0 - unit(gen); };
+    std::uniform_int_distribution<size_t> slot(0, n_samples - 1);
+
+    // Skip over the lines that would not enter the reservoir (Algorithm L)
+    double w = std::exp(std::log(random()) / n_samples);
+    size_t i = n_samples - 1;
+    while (true)
+    {
+      double skip = std::floor(std::log(random()) / std::log(1.0 - w));
+      if (!(skip < (double)(lines.size() - i - 1)))
+        break;
+      i += (size_t)skip + 1;
+
+      // The line replaces a random line of the reservoir
+      sampled[slot(gen)] = lines[i];
+      w *= std::exp(std::log(random()) / n_samples);
+    }
+  }
+  else if (sampling == STRATIFIED_SAMPLING)
+  {
+    // Draw one line from each of n_samples equal ranges of lines
+    sampled.reserve(n_samples);
+    for (size_t k = 0; k < n_samples; k++)
+    {
+      size_t begin = lines.size() * k / n_samples;
+      size_t end = lines.size() * (k + 1) / n_samples;
+      std::uniform_int_distribution<size_t> dist(begin, end - 1);
+      sampled.push_back(lines[dist(gen)]);
+    }
+  }
+  else
+  {
+    // Shuffle the positions of the lines lazily (Fisher-Yates, storing only
+    // the positions that were swapped)
+    std::unordered_map<size_t, size_t> swapped;
+    auto at = [&](size_t pos)
+    {
+      auto it = swapped.find(pos);
+      return it == swapped.end() ? pos : it->second;
+    };
+
+    // Draw distinct lines until the sample holds the target number of bytes
+    size_t bytes = 0;
+    for (size_t drawn = 0; drawn < std::min(n_samples, lines.size()) &&
+                           bytes < target_bytes;
+         drawn++)
+    {
+      std::uniform_int_distribution<size_t> dist(drawn, lines.size() - 1);
+      size_t pos = dist(gen);
+      size_t line = at(pos);
+      swapped[pos] = at(drawn);
+
+      // Truncate the line to stay within twice the target number of bytes
+      sampled.push_back(lines[line].substr(0, 2 * target_bytes - bytes));
+      bytes += sampled.back().size();
+    }
+  }
+
+  return sampled;
+}
+
+void count_distinct_strings(const std::vector<std::string_view> &strs,
+                            std::vector<std::string_view> &distinct,
+                            std::vector<unsigned int> &counts)
+{
+  // Hash every string to its distinct string (in the order of their first
+  // occurrence)
+  std::unordered_map<std::string_view, size_t> positions;
+  positions.reserve(strs.size());
+  for (std::string_view str : strs)
+  {
+    auto inserted = positions.emplace(str, distinct.size());
+    if (inserted.second)
+    {
+      distinct.push_back(str);
+      counts.push_back(1);
+    }
+    else
+      counts[inserted.first->second]++;
+  }
+}
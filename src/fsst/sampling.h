@@ -0,0 +1,86 @@
+#ifndef FSST_WITH_FST_SAMPLING_H
+#define FSST_WITH_FST_SAMPLING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief The ways the lines of a batch are sampled for the FST.
+ */
+enum SamplingMode
+{
+  /**
+   * @brief Draw n_samples distinct lines uniformly at random (reservoir
+   * sampling with skips, O(n_samples * log(lines / n_samples))).
+   */
+  RESERVOIR_SAMPLING,
+
+  /**
+   * @brief Split the lines into n_samples equal ranges and draw one line from
+   * each (covers the whole batch, O(n_samples)).
+   */
+  STRATIFIED_SAMPLING,
+
+  /**
+   * @brief Draw distinct lines uniformly at random until they hold the target
+   * number of bytes (at most n_samples lines, truncating the last one to stay
+   * within twice the target) like FSST's own sample.
+   */
+  BYTE_BUDGET_SAMPLING
+};
+
+/**
+ * @brief The seed used for sampling if none is given (runs are reproducible).
+ */
+constexpr uint64_t DEFAULT_SAMPLING_SEED = 42;
+
+/**
+ * @brief The number of bytes FSST samples (FSST_SAMPLETARGET of
+ * lib/fsst/libfsst.hpp).
+ */
+constexpr size_t FSST_SAMPLE_TARGET_BYTES = 1 << 14;
+
+/**
+ * @brief The number of bytes FSST12 samples (FSST_SAMPLETARGET of
+ * lib/fsst/libfsst12.cpp).
+ */
+constexpr size_t FSST12_SAMPLE_TARGET_BYTES = 1 << 17;
+
+/**
+ * @brief Take a view on every line of a batch (a trailing newline does not
+ * start a new line).
+ * @param str The batch.
+ * @return The lines (views into the batch).
+ */
+std::vector<std::string_view> split_string_by_newline(std::string_view str);
+
+/**
+ * @brief Sample lines from a batch.
+ * @param lines The lines of the batch.
+ * @param n_samples The number of lines to sample (all lines are taken if
+ * there are not more).
+ * @param sampling The way the lines are sampled.
+ * @param seed The seed of the sampling (equal seeds draw equal samples).
+ * @param target_bytes The number of bytes to sample with BYTE_BUDGET_SAMPLING.
+ * @return The sampled lines (views into the batch, or prefixes of them).
+ */
+std::vector<std::string_view>
+sample_lines(const std::vector<std::string_view> &lines, size_t n_samples,
+             SamplingMode sampling = RESERVOIR_SAMPLING,
+             uint64_t seed = DEFAULT_SAMPLING_SEED,
+             size_t target_bytes = FSST_SAMPLE_TARGET_BYTES);
+
+/**
+ * @brief Count the distinct strings of a sample.
+ * @param strs The sampled strings.
+ * @param distinct Receives the distinct strings (in the order of their first
+ * occurrence).
+ * @param counts Receives the number of occurrences of every distinct string.
+ */
+void count_distinct_strings(const std::vector<std::string_view> &strs,
+                            std::vector<std::string_view> &distinct,
+                            std::vector<unsigned int> &counts);
+
+#endif
@@ -1,9 +1,11 @@
 using namespace std;
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
 
+#include "../classes/aho_corasick.h"
 #include "string_helpers.h"
 
 // ---------------------------------------------------------------------------------------------
@@ -160,31 +162,86 @@ string_helpers::delete_contained_substrings_helper(string str,
 
 list<string> string_helpers::delete_contained_substrings(list<string> strings)
 {
-  // Make a copy of the list
-  list<string> strings_copy = strings;
-
-  // Sort the list by length (longest first)
-  strings_copy.sort(
-      [](const string &a, const string &b)
-      { return a.length() > b.length(); });
+  // Every string is a distinct string with one copy (copies of a string are
+  // consumed in the order of the list)
+  vector<pair<string_view, unsigned int>> counted_strings;
+  for (const string &str : strings)
+    counted_strings.emplace_back(str, 1);
 
-  // Make an empty return list
+  // Make the return list
   list<string> strings_return;
+  for (const pair<string_view, unsigned int> &str :
+       delete_contained_substrings(counted_strings))
+    strings_return.emplace_back(str.first);
 
-  // As long as the list is not empty
-  while (!strings_copy.empty())
+  // Return the list
+  return strings_return;
+}
+
+vector<pair<string_view, unsigned int>>
+string_helpers::delete_contained_substrings(
+    vector<pair<string_view, unsigned int>> strings)
+{
+  // Sort the strings by length (longest first, keeping the order of strings
+  // with the same length)
+  stable_sort(strings.begin(), strings.end(),
+              [](const pair<string_view, unsigned int> &a,
+                 const pair<string_view, unsigned int> &b)
+              { return a.first.length() > b.first.length(); });
+
+  // Build an automaton to find all strings contained in a string at once
+  vector<string_view> patterns;
+  patterns.reserve(strings.size());
+  for (const pair<string_view, unsigned int> &str : strings)
+    patterns.push_back(str.first);
+  AhoCorasick automaton(patterns);
+
+  // For every string the strings contained in it (not considering the first
+  // character) in the order of the list, found once the string is needed
+  // first, and the position of the first one that might still have a copy
+  // (strings are only ever removed, so this only moves forward)
+  vector<vector<uint32_t>> contained(strings.size());
+  vector<bool> found(strings.size(), false);
+  vector<size_t> next(strings.size(), 0);
+
+  // Find the first copy contained in a string
+  auto find_contained = [&](size_t i)
   {
-    // Get the first string
-    string str = strings_copy.front();
+    if (!found[i])
+    {
+      contained[i] = automaton.getContainedPatterns(strings[i].first.substr(1));
+      sort(contained[i].begin(), contained[i].end());
+      found[i] = true;
+    }
 
-    // Remove the first string from the list
-    strings_copy.pop_front();
+    while (next[i] < contained[i].size())
+    {
+      uint32_t j = contained[i][next[i]];
+      if (j > i && strings[j].second > 0)
+        return (size_t)j;
+      next[i]++;
+    }
+    return strings.size();
+  };
 
-    // Remove all substrings contained in the string
-    strings_copy = delete_contained_substrings_helper(str, strings_copy);
+  // Make an empty return list
+  vector<pair<string_view, unsigned int>> strings_return;
 
-    // Add the string to the return list
-    strings_return.push_back(str);
+  // Take every remaining copy in order
+  for (size_t i = 0; i < strings.size(); i++)
+  {
+    if (strings[i].second == 0)
+      continue;
+    strings_return.emplace_back(strings[i].first, strings[i].second);
+
+    for (unsigned int copy = 0; copy < strings_return.back().second; copy++)
+    {
+      // Remove the copy of the first contained string and continue with the
+      // strings contained in it
+      for (size_t j = find_contained(i); j < strings.size();
+           j = find_contained(j))
+        strings[j].second--;
+    }
   }
 
   // Return the list
@@ -194,35 +251,43 @@ list<string> string_helpers::delete_contained_substrings(list<string> strings)
 list<string> string_helpers::get_substrings_to_delete(string substr,
                                                       list<string> strings)
 {
-  // Make a copy of the list
-  list<string> strings_copy = strings;
+  // Every string is a distinct string with one copy
+  vector<pair<string_view, unsigned int>> counted_strings;
+  for (const string &str : strings)
+    counted_strings.emplace_back(str, 1);
 
-  // Prepare the return list
+  // Make the return list
   list<string> strings_return;
+  for (const pair<string_view, unsigned int> &str :
+       get_substrings_to_delete(substr, counted_strings))
+    strings_return.emplace_back(str.first);
 
-  // For each string in the list
-  for (list<string>::iterator it = strings_copy.begin();
-       it != strings_copy.end(); ++it)
-  {
-    // Get the string
-    string current_string = *it;
+  // Return the list
+  return strings_return;
+}
 
-    // Find the first occurrence of the substring in the current_string
-    size_t pos = current_string.find(substr);
+vector<pair<string_view, unsigned int>>
+string_helpers::get_substrings_to_delete(
+    string_view substr, const vector<pair<string_view, unsigned int>> &strings)
+{
+  // Prepare the return list
+  vector<pair<string_view, unsigned int>> strings_return;
 
-    // While the substring is found
-    while (pos != string::npos)
-    {
-      // Get the substring
-      string current_substring =
-          current_string.substr(pos, current_string.length() - pos);
+  // An empty substring does not start anything to delete
+  if (substr.empty())
+    return strings_return;
 
-      // Add the substring to the return list
-      strings_return.push_back(current_substring);
+  // Build an automaton for the substring
+  AhoCorasick automaton({substr});
 
-      // Find the next occurrence of the substring in the current_string
-      pos = current_string.find(substr, pos + substr.length());
-    }
+  // For each string in the list
+  for (const pair<string_view, unsigned int> &str : strings)
+  {
+    // Every occurrence of the substring (not overlapping the previous one)
+    // starts a substring to delete
+    for (size_t pos = automaton.find(str.first); pos != string_view::npos;
+         pos = automaton.find(str.first, pos + substr.length()))
+      strings_return.emplace_back(str.first.substr(pos), str.second);
   }
 
   // Return the list
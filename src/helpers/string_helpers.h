@@ -6,7 +6,10 @@ using namespace std;
 #include <list>
 #include <set>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 // ---------------------------------------------------------------------------------------------
 // Namespace string_helpers
@@ -74,6 +77,21 @@ namespace string_helpers
      */
     list<string> delete_contained_substrings(list<string> strings);
 
+    /**
+     * @brief Delete all substrings that are contained in other strings, like
+     * delete_contained_substrings() but for distinct strings with their number
+     * of copies (the copies of a string have to be consecutive in the list
+     * delete_contained_substrings() would get). The contained strings are
+     * found with an Aho-Corasick automaton over all strings, so this takes
+     * O(total length of the strings + number of contained pairs + copies *
+     * length of the removal chains), without copying any string.
+     * @param strings The distinct strings with their number of copies.
+     * @return The remaining strings with their number of copies (in the order
+     * delete_contained_substrings() returns them).
+     */
+    vector<pair<string_view, unsigned int>>
+    delete_contained_substrings(vector<pair<string_view, unsigned int>> strings);
+
     /**
      * @brief Get the correct substrings to delete from the fstc (e.g. if
      * "TESTESTEST" and "TESTER" are given in the list of strings and the str(ing to
@@ -84,6 +102,20 @@ namespace string_helpers
      */
     list<string> get_substrings_to_delete(string str, list<string> strings);
 
+    /**
+     * @brief Get the correct substrings to delete from the fstc, like
+     * get_substrings_to_delete() but for distinct strings with their number of
+     * copies. Takes O(total length of the strings + length of str), without
+     * copying any string.
+     * @param str The string to analyze.
+     * @param strings The distinct potential substrings to delete with their
+     * number of copies.
+     * @return The substrings to delete with their number of copies.
+     */
+    vector<pair<string_view, unsigned int>>
+    get_substrings_to_delete(string_view str,
+                             const vector<pair<string_view, unsigned int>> &strings);
+
 } // namespace string_helpers
 
 #endif
@@ -0,0 +1,94 @@
+// Library includes
+using namespace std;
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../classes/aho_corasick.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are focussed on testing the functionality of the class as a whole
+
+TEST_CASE("Check if the automaton finds the contained patterns")
+{
+  SUBCASE("Patterns that are suffixes of each other")
+  {
+    AhoCorasick automaton({"TESTEST", "TEST", "EST", "ST", "TEST", "X"});
+
+    vector<uint32_t> contained = automaton.getContainedPatterns("ESTESTER");
+    sort(contained.begin(), contained.end());
+    CHECK(contained == vector<uint32_t>({1, 2, 3, 4}));
+
+    contained = automaton.getContainedPatterns("TESTEST");
+    sort(contained.begin(), contained.end());
+    CHECK(contained == vector<uint32_t>({0, 1, 2, 3, 4}));
+
+    CHECK(automaton.getContainedPatterns("").empty());
+  }
+
+  SUBCASE("Random patterns and texts")
+  {
+    // Compare with string::find on a small alphabet (many matches)
+    mt19937 generator(42);
+    uniform_int_distribution<int> symbols(0, 2), lengths(1, 6);
+    auto random_string = [&](int length)
+    {
+      string str;
+      for (int i = 0; i < length; i++)
+        str.push_back("abc"[symbols(generator)]);
+      return str;
+    };
+
+    vector<string> patterns;
+    for (int i = 0; i < 40; i++)
+      patterns.push_back(random_string(lengths(generator)));
+    AhoCorasick automaton(vector<string_view>(patterns.begin(), patterns.end()));
+
+    for (int text_nr = 0; text_nr < 20; text_nr++)
+    {
+      string text = random_string(30);
+
+      vector<uint32_t> expected;
+      for (uint32_t i = 0; i < patterns.size(); i++)
+        if (text.find(patterns[i]) != string::npos)
+          expected.push_back(i);
+
+      vector<uint32_t> contained = automaton.getContainedPatterns(text);
+      sort(contained.begin(), contained.end());
+      CHECK(contained == expected);
+    }
+  }
+}
+
+TEST_CASE("Check if the automaton finds the first occurrence")
+{
+  SUBCASE("A single pattern behaves like string::find")
+  {
+    string text = "TESTESTERTEST";
+    AhoCorasick automaton({"TEST"});
+    for (size_t pos = 0; pos <= text.length() + 1; pos++)
+      CHECK(automaton.find(text, pos) == text.find("TEST", pos));
+  }
+
+  SUBCASE("The occurrence ending first is found")
+  {
+    AhoCorasick automaton({"BCDE", "CD"});
+    CHECK(automaton.find("ABCDE") == 2);
+    CHECK(automaton.find("ABCXE") == string_view::npos);
+  }
+
+  SUBCASE("An empty pattern occurs at the start")
+  {
+    AhoCorasick automaton({""});
+    CHECK(automaton.find("ABC", 1) == 1);
+    CHECK(automaton.getContainedPatterns("ABC") == vector<uint32_t>({0}));
+  }
+}
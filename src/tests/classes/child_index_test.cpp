@@ -0,0 +1,100 @@
+// Library includes
+using namespace std;
+#include <iostream>
+#include <string>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../classes/child_index.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are focussed on testing the functionality of the class as a whole
+
+TEST_CASE("Check if a child index grows and shrinks through all layouts")
+{
+  ChildPools pools;
+  ChildIndex index;
+
+  SUBCASE("Insert and erase all 256 symbols")
+  {
+    // Insert all symbols in a scrambled order
+    for (unsigned int i = 0; i < 256; i++)
+    {
+      unsigned char symbol = (i * 167) & 255;
+      pools.insert(index, symbol, 1000 + symbol);
+
+      // Check if the layout fits the number of children
+      if (i + 1 == 1)
+        CHECK(index.kind == ChildIndex::SINGLE);
+      if (i + 1 == 4)
+        CHECK(index.kind == ChildIndex::N4);
+      if (i + 1 == 16)
+        CHECK(index.kind == ChildIndex::N16);
+      if (i + 1 == 48)
+        CHECK(index.kind == ChildIndex::N48);
+      if (i + 1 == 49)
+        CHECK(index.kind == ChildIndex::N256);
+    }
+
+    // Check if all children can be found and are in the order they were
+    // added
+    CHECK(index.count == 256);
+    for (unsigned int i = 0; i < 256; i++)
+    {
+      CHECK(pools.find(index, i) == 1000 + i);
+      CHECK(pools.at(index, i) == 1000 + ((i * 167) & 255));
+    }
+
+    // Erase all symbols but one, checking the lookups and the order of the
+    // remaining children in between
+    for (unsigned int i = 0; i < 255; i++)
+    {
+      unsigned char symbol = (i * 167) & 255;
+      pools.erase(index, symbol);
+      CHECK(pools.find(index, symbol) == ChildPools::NO_CHILD);
+      CHECK(pools.find(index, (unsigned char)(symbol + 167)) ==
+            1000 + (unsigned char)(symbol + 167));
+      for (unsigned int j = 0; j < index.count; j++)
+        CHECK(pools.at(index, j) == 1000 + (((i + 1 + j) * 167) & 255));
+    }
+
+    // Only a single child should be left
+    CHECK(index.kind == ChildIndex::SINGLE);
+    CHECK(index.count == 1);
+
+    // Clean up
+    pools.clear(index);
+    CHECK(index.kind == ChildIndex::EMPTY);
+  }
+
+  SUBCASE("Children of a small index are in the order they were added")
+  {
+    // Insert some symbols
+    pools.insert(index, 'T', 1);
+    pools.insert(index, 'A', 2);
+    pools.insert(index, 'M', 3);
+    pools.insert(index, (unsigned char)0xE4, 4);
+
+    // Check the order
+    CHECK(pools.at(index, 0) == 1);
+    CHECK(pools.at(index, 1) == 2);
+    CHECK(pools.at(index, 2) == 3);
+    CHECK(pools.at(index, 3) == 4);
+
+    // Erasing a child keeps the order of the others
+    pools.erase(index, 'A');
+    CHECK(pools.at(index, 0) == 1);
+    CHECK(pools.at(index, 1) == 3);
+    CHECK(pools.at(index, 2) == 4);
+
+    // Missing symbols should not be found
+    CHECK(pools.find(index, 'B') == ChildPools::NO_CHILD);
+
+    // Clean up
+    pools.clear(index);
+  }
+}
@@ -0,0 +1,144 @@
+// Library includes
+using namespace std;
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../classes/fst.h"
+#include "../../classes/fst_snapshot.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are focussed on testing the functionality of the class as a whole
+
+TEST_CASE("Check if an FST is restored from its snapshot")
+{
+  string path =
+      (filesystem::temp_directory_path() / "fst_snapshot_test.fst").string();
+
+  SUBCASE("Strings TEST, TARGET and DOMINIK")
+  {
+    // Create the FST
+    FST *fst = new FST();
+    fst->addString("TEST");
+    fst->addString("TARGET");
+    fst->addString("DOMINIK");
+
+    // Save and load it
+    fst->save(path);
+    FST *loaded = FST::load(path);
+    CHECK(*loaded == *fst);
+
+    // Clean up
+    delete fst;
+    delete loaded;
+  }
+
+  SUBCASE("Limited depth, overlaps and symbols above 127")
+  {
+    // Create the FST
+    FST *fst = new FST(3);
+    fst->addString("aaaa\xe4\xf6\xfc");
+    fst->addString("abab\xe4\xe4");
+    fst->getDictionaryEntries(2, 3);
+
+    // Save and load it
+    fst->save(path);
+    FST *loaded = FST::load(path);
+    CHECK(loaded->getMaxDepth() == 3);
+    CHECK(*loaded == *fst);
+
+    // Clean up
+    delete fst;
+    delete loaded;
+  }
+
+  SUBCASE("A capped FST whose suffixes were not cut")
+  {
+    // Create the FST (every string is shorter than the cap)
+    FST *fst = new FST(7);
+    for (string str : {"CBCBCA", "CBCAAA", "CCCBCB", "CBC", "ACCACB"})
+      fst->addString(string_view(str));
+
+    // Save and load it, both select the dictionary exactly
+    fst->save(path);
+    FST *loaded = FST::load(path);
+    CHECK(*loaded == *fst);
+    CHECK(loaded->getDictionaryEntries(4, 7) ==
+          fst->getDictionaryEntries(4, 7));
+
+    // Clean up
+    delete fst;
+    delete loaded;
+  }
+
+  SUBCASE("An empty FST")
+  {
+    // Create the FST
+    FST *fst = new FST();
+
+    // Save and load it
+    fst->save(path);
+    FST *loaded = FST::load(path);
+    CHECK(loaded->getNrPaths() == 0);
+    CHECK(*loaded == *fst);
+
+    // Clean up
+    delete fst;
+    delete loaded;
+  }
+
+  filesystem::remove(path);
+}
+
+TEST_CASE("Check if a mapped snapshot answers like the FST")
+{
+  string path =
+      (filesystem::temp_directory_path() / "fst_snapshot_test.fst").string();
+
+  // Create the FST
+  FST *fst = new FST();
+  fst->addString("TESTEST");
+  fst->addString("TARGET\xff");
+  fst->save(path);
+
+  SUBCASE("Nodes representing substrings")
+  {
+    FSTSnapshot snapshot(path);
+    CHECK(snapshot.getNrRoots() == fst->getNrPaths());
+
+    for (string substring : {"T", "TE", "TEST", "ST", "GET\xff", "\xff"})
+    {
+      uint32_t id = snapshot.getNodeRepresentingSubstring(substring);
+      Node *node = fst->getNodeRepresentingSubstring(substring);
+      REQUIRE(id != FSTSnapshot::NO_NODE);
+      CHECK(snapshot.getSymbol(id) == node->getSymbol());
+      CHECK(snapshot.getFrequency(id) == node->getFrequency());
+      CHECK(snapshot.getNrChildren(id) == node->getNrChildren());
+    }
+
+    CHECK(snapshot.getNodeRepresentingSubstring("TESTER") ==
+          FSTSnapshot::NO_NODE);
+    CHECK(snapshot.getNodeRepresentingSubstring("X") == FSTSnapshot::NO_NODE);
+  }
+
+  SUBCASE("Files that are not snapshots")
+  {
+    CHECK_THROWS_AS(FSTSnapshot{path + ".missing"}, runtime_error);
+
+    ofstream(path, ios::binary | ios::trunc) << "not a snapshot";
+    CHECK_THROWS_AS(FSTSnapshot{path}, runtime_error);
+    CHECK_THROWS_AS(FST::load(path), runtime_error);
+  }
+
+  // Clean up
+  delete fst;
+  filesystem::remove(path);
+}
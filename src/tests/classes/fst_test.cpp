@@ -3,13 +3,17 @@ using namespace std;
 #include <algorithm>
 #include <iostream>
 #include <list>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 // Doctest include
 #include "../doctest/doctest.h"
 
 // Include the files to test
 #include "../../classes/fst.h"
+#include "../../helpers/string_helpers.h"
 
 // ---------------------------------------------------------------------------------------------
 // Class-level tests
@@ -699,6 +703,493 @@ TEST_CASE("Test whether the substring replacement works correctly")
   }
 }
 
+TEST_CASE("Check if the depth cap limits the insertion of suffixes")
+{
+  SUBCASE("FST with the strings TESTESTE and TEST capped at level 2")
+  {
+    // Create the FSTs
+    FST *fst = new FST(2);
+    FST *uncapped_fst = new FST();
+
+    // Add the strings themselves to the FSTs
+    fst->addStrings({"TESTESTE", "TEST"});
+    uncapped_fst->addStrings({"TESTESTE", "TEST"});
+
+    // No node deeper than level 2 should exist
+    CHECK(fst->getMaxDepth() == 2);
+    CHECK(fst->getNodeRepresentingSubstring("TES") != NULL);
+    CHECK(fst->getNodeRepresentingSubstring("TEST") == NULL);
+    CHECK(fst->getNodeRepresentingSubstring("STE") != NULL);
+    CHECK(fst->getNodeRepresentingSubstring("STES") == NULL);
+
+    // The frequencies and overlaps up to level 2 should be exact
+    for (string substring : {"T", "TE", "TES", "ES", "EST", "STE", "E"})
+    {
+      Node *node = fst->getNodeRepresentingSubstring(substring);
+      Node *uncapped_node = uncapped_fst->getNodeRepresentingSubstring(substring);
+      CHECK(node->getFrequency() == uncapped_node->getFrequency());
+      CHECK(node->getOverlaps() == uncapped_node->getOverlaps());
+    }
+
+    // Clean up
+    delete fst;
+    delete uncapped_fst;
+  }
+
+  SUBCASE("Dictionary entries of an FST capped at level 7")
+  {
+    // Create the FST
+    FST *fst = new FST(7);
+
+    // Add the strings themselves to the FST
+    fst->addStrings({"TESTESTESTESTESTEST", "ATTESTATION", "TESTER",
+                     "HOTTEST DAY", "PROTESTERS", "ESTIMATE", "TESTED",
+                     "WRONGESTIMATE", "CONTESTANT", "TESTESTDOMINIKTESTEST"});
+
+    // Get the dictionary entries
+    list<string> dict_entries;
+    CHECK_NOTHROW(dict_entries = fst->getDictionaryEntries(255, 7));
+
+    // Check if the dictionary entries are valid
+    CHECK(dict_entries.size() > 0);
+    for (string entry : dict_entries)
+      CHECK(entry.length() <= 8);
+
+    // Clean up
+    delete fst;
+  }
+
+  SUBCASE("Dictionary entries of an FST whose cap does not bind")
+  {
+    // No string is longer than the cap allows, so no suffix is cut
+    list<string> generated_strings;
+    for (unsigned int i = 0; i < 200; i++)
+      generated_strings.push_back(("TEST" + string(i % 3, 'E') +
+                                   to_string(i * 7919 % 100) + "EST")
+                                      .substr(0, 6));
+
+    for (const list<string> &strings :
+         {list<string>{"BBBB", "A", "BABABA", "BBABAB", "BABAA"},
+          generated_strings})
+    {
+      // Create the FSTs
+      FST *fst = new FST(5);
+      FST *uncapped_fst = new FST();
+
+      // Add the strings themselves to the FSTs
+      fst->addStrings(strings);
+      uncapped_fst->addStrings(strings);
+
+      // Both FSTs should be equal and give the same dictionary entries
+      CHECK(*fst == *uncapped_fst);
+      CHECK(fst->getDictionaryEntries(5, 5) ==
+            uncapped_fst->getDictionaryEntries(5, 5));
+
+      // Clean up
+      delete fst;
+      delete uncapped_fst;
+    }
+  }
+}
+
+TEST_CASE("Check if merged and parallel built FSTs equal sequential ones")
+{
+  SUBCASE("Merge of the FSTs of TESTESTE, TEST and TEMPO, ATTEST")
+  {
+    // Create the FSTs
+    FST *fst = new FST();
+    FST *other_fst = new FST();
+    FST *expected_fst = new FST();
+
+    // Add the strings to two FSTs and to a single one
+    fst->addStrings({"TESTESTE", "TEST"});
+    other_fst->addStrings({"TEMPO", "ATTEST"});
+    expected_fst->addStrings({"TESTESTE", "TEST", "TEMPO", "ATTEST"});
+
+    // The merged FST should be equal to the single one
+    fst->merge(*other_fst);
+    CHECK(*fst == *expected_fst);
+    CHECK(fst->getNodeRepresentingSubstring("TEST")->getFrequency() == 4);
+
+    // FSTs with different depth caps cannot be merged
+    FST *capped_fst = new FST(3);
+    CHECK_THROWS_AS(fst->merge(*capped_fst), invalid_argument);
+
+    // Clean up
+    delete fst;
+    delete other_fst;
+    delete expected_fst;
+    delete capped_fst;
+  }
+
+  SUBCASE("Parallel build of 200 strings with 4 threads")
+  {
+    // Create the FSTs
+    FST *fst = new FST(7);
+    FST *expected_fst = new FST(7);
+
+    // Build some strings
+    vector<string> strings;
+    for (unsigned int i = 0; i < 200; i++)
+      strings.push_back("TEST" + to_string(i * 7919 % 1000) + "ESTI" +
+                        string(i % 5, 'E'));
+    vector<string_view> views(strings.begin(), strings.end());
+
+    // Add the strings in parallel resp. one by one
+    fst->addStringsInParallel(views, 4);
+    for (string str : strings)
+      expected_fst->addString(str);
+
+    // Both FSTs should be equal and give the same dictionary entries
+    CHECK(*fst == *expected_fst);
+    CHECK(fst->getDictionaryEntries(50, 7) ==
+          expected_fst->getDictionaryEntries(50, 7));
+
+    // Clean up
+    delete fst;
+    delete expected_fst;
+  }
+}
+
+TEST_CASE("Check if the suffix array backend builds the same FST")
+{
+  SUBCASE("FST with the strings TESTESTE, TEST, EST, TATATA and ATTEST")
+  {
+    // Create the FSTs
+    FST *fst = new FST();
+    FST *expected_fst = new FST();
+
+    // Add the strings with the suffix array resp. one by one
+    vector<string_view> strings = {"TESTESTE", "TEST", "", "TATATA", "ATTEST"};
+    fst->addStrings(strings, FST::SUFFIX_ARRAY);
+    for (string_view str : strings)
+      expected_fst->addString(str);
+
+    // Both FSTs should be equal
+    CHECK(*fst == *expected_fst);
+    CHECK(fst->getNodeRepresentingSubstring("TATA")->getOverlaps() == 1);
+
+    // Adding more strings to an existing FST should work as well
+    fst->addStrings({"TESTER", "ESTIMATE"}, FST::SUFFIX_ARRAY);
+    expected_fst->addStrings({"TESTER", "ESTIMATE"});
+    CHECK(*fst == *expected_fst);
+
+    // Clean up
+    delete fst;
+    delete expected_fst;
+  }
+
+  SUBCASE("FST with 200 strings capped at level 7")
+  {
+    // Create the FSTs
+    FST *fst = new FST(7);
+    FST *expected_fst = new FST(7);
+
+    // Build some strings
+    vector<string> strings;
+    for (unsigned int i = 0; i < 200; i++)
+      strings.push_back("TEST" + to_string(i * 7919 % 1000) + "ESTI" +
+                        string(i % 5, 'E') + "\xe4\xe4\xe4");
+    vector<string_view> views(strings.begin(), strings.end());
+
+    // Add the strings with the suffix array resp. one by one
+    fst->addStrings(views, FST::SUFFIX_ARRAY);
+    for (string str : strings)
+      expected_fst->addString(str);
+
+    // Both FSTs should be equal and give the same dictionary entries
+    CHECK(*fst == *expected_fst);
+    CHECK(fst->getDictionaryEntries(50, 7) ==
+          expected_fst->getDictionaryEntries(50, 7));
+
+    // Clean up
+    delete fst;
+    delete expected_fst;
+  }
+}
+
+TEST_CASE("Check if the space saving backend builds the same FST")
+{
+  SUBCASE("FST with 200 strings capped at level 7 resp. 3")
+  {
+    // Build some strings (all their substrings fit into the counters)
+    vector<string> strings;
+    for (unsigned int i = 0; i < 200; i++)
+      strings.push_back("TEST" + to_string(i * 7919 % 1000) + "ESTI" +
+                        string(i % 5, 'E') + "\xe4\xe4\xe4");
+    vector<string_view> views(strings.begin(), strings.end());
+
+    for (unsigned int max_depth : {7U, 3U})
+    {
+      // Create the FSTs
+      FST *fst = new FST(max_depth);
+      FST *expected_fst = new FST(max_depth);
+
+      // Add the strings with the counters resp. one by one
+      fst->addStrings(views, FST::SPACE_SAVING);
+      for (string str : strings)
+        expected_fst->addString(str);
+
+      // Both FSTs should be equal and give the same dictionary entries
+      CHECK(*fst == *expected_fst);
+      CHECK(fst->getDictionaryEntries(50, 7) ==
+            expected_fst->getDictionaryEntries(50, 7));
+
+      // Clean up
+      delete fst;
+      delete expected_fst;
+    }
+  }
+
+  SUBCASE("Prefixes that were not kept")
+  {
+    // Create the FST
+    FST *fst = new FST(7);
+
+    // Only the substrings of length 3 are counted
+    SpaceSaving counter(10, 3, 3);
+    counter.addString("ABCABD");
+    fst->addHeavyHitters(counter);
+
+    // The prefixes occur as often as their children together
+    CHECK(fst->getNodeRepresentingSubstring("AB")->getFrequency() == 2);
+    CHECK(fst->getNodeRepresentingSubstring("ABC")->getFrequency() == 1);
+    CHECK(fst->getPath('A')->getFrequency() == 2);
+    CHECK(fst->getPath('D')->getFrequency() == 1);
+
+    // Clean up
+    delete fst;
+  }
+}
+
+TEST_CASE("Check if the dictionary entries are selected by the highest gain")
+{
+  SUBCASE("FST with the strings TESTESTESTEST, ATTESTATION, TESTER, "
+          "PROTESTERS and ESTIMATE")
+  {
+    // Create two equal FSTs
+    FST *fst = new FST();
+    FST *expected_fst = new FST();
+    list<string> strings = {"TESTESTESTEST", "ATTESTATION", "TESTER",
+                            "PROTESTERS", "ESTIMATE"};
+    fst->addStrings(strings);
+    expected_fst->addStrings(strings);
+
+    // Get the dictionary entries (with their replaceable occurrences)
+    vector<unsigned int> occurrences;
+    list<string> dict_entries = fst->getDictionaryEntries(20, 7, &occurrences);
+
+    // Select the entries from the fully sorted gain list instead
+    list<string> expected_dict_entries;
+    vector<unsigned int> expected_occurrences;
+    for (unsigned int i = 0; i < 20; i++)
+    {
+      list<Node *> sorted_gain_list = expected_fst->getSortedGainList(7);
+      if (sorted_gain_list.empty())
+        break;
+      Node *node = sorted_gain_list.front();
+      expected_dict_entries.push_back(node->getSubstring());
+      expected_occurrences.push_back(node->getFrequency() - node->getOverlaps());
+      expected_fst->handleSubstringAddedToDict(node);
+    }
+
+    // Both should select the same entries and leave the same FST
+    CHECK(dict_entries == expected_dict_entries);
+    CHECK(occurrences == expected_occurrences);
+    CHECK(*fst == *expected_fst);
+
+    // Clean up
+    delete fst;
+    delete expected_fst;
+  }
+
+  SUBCASE("Ties of the first 3 strings from the dbtext/street database")
+  {
+    // Entries with equal gains are selected in the order their substrings
+    // first occurred (by both backends)
+    vector<string> strings = {"VARICK ST", "PORTLAND AVE N", "95 ST"};
+    vector<string_view> views(strings.begin(), strings.end());
+    list<string> expected_dict_entries = {"VARICK S", "AND AVE ", "PORTL",
+                                          "95 ST"};
+
+    for (FST::CountingBackend backend : {FST::SUFFIX_TRIE, FST::SUFFIX_ARRAY})
+    {
+      FST *fst = new FST();
+      fst->addStrings(views, backend);
+      CHECK(fst->getDictionaryEntries(255, 7) == expected_dict_entries);
+      delete fst;
+    }
+  }
+}
+
+TEST_CASE("Check if overlaps are counted while strings are added")
+{
+  SUBCASE("FST with the strings TESTESTEST, AAAAA, TATATA and TEST")
+  {
+    // Create the FST
+    FST *fst = new FST();
+
+    // Add the strings themselves to the FST
+    list<string> strings = {"TESTESTEST", "AAAAA", "TATATA", "TEST"};
+    fst->addStrings(strings);
+
+    // The overlaps of every node should be the occurrences that cannot be
+    // replaced from left to right
+    for (string substring : {"TEST", "TESTEST", "EST", "AA", "AAA", "TATA",
+                             "ATA", "T", "ST"})
+    {
+      unsigned int overlaps = 0;
+      for (string str : strings)
+        overlaps +=
+            string_helpers::number_of_occurrences_with_overlap(str, substring) -
+            string_helpers::number_of_occurrences_without_overlap(str,
+                                                                  substring);
+      CHECK(fst->getNodeRepresentingSubstring(substring)->getOverlaps() ==
+            overlaps);
+    }
+    CHECK(fst->getNodeRepresentingSubstring("AA")->getOverlaps() == 2);
+
+    // Clean up
+    delete fst;
+  }
+}
+
+TEST_CASE("Check if strings can be added in place from a block buffer")
+{
+  SUBCASE("Lines TESTESTE, TEST and TEMPO within a single buffer")
+  {
+    // Create the FSTs
+    FST *fst = new FST();
+    FST *expected_fst = new FST();
+
+    // Add the lines as views into the buffer (none of them is zero-terminated)
+    const char buffer[] = {'T', 'E', 'S', 'T', 'E', 'S', 'T', 'E', '\n',
+                           'T', 'E', 'S', 'T', '\n', 'T', 'E', 'M', 'P', 'O'};
+    string_view block(buffer, sizeof(buffer));
+    fst->addString(block.substr(0, 8));
+    fst->addString(block.substr(9, 4));
+    fst->addString(buffer + 14, 5);
+
+    // Add the same strings as copies
+    expected_fst->addStrings({"TESTESTE", "TEST", "TEMPO"});
+
+    // Both FSTs should be equal
+    CHECK(*fst == *expected_fst);
+    CHECK(fst->getNodeRepresentingSubstring("TESTESTE")->getFrequency() == 1);
+    CHECK(fst->getNodeRepresentingSubstring("TEST")->getOverlaps() == 1);
+    CHECK(fst->getNodeRepresentingSubstring("TEMPO") != NULL);
+
+    // Clean up
+    delete fst;
+    delete expected_fst;
+  }
+}
+
+TEST_CASE("Check if weighted strings are added like repeated strings")
+{
+  // The strings with their number of occurrences
+  vector<string_view> strings = {"TESTESTE", "TEST", "TATATA", "ATTEST"};
+  vector<unsigned int> weights = {3, 1, 4, 2};
+
+  SUBCASE("Single strings and both backends")
+  {
+    for (unsigned int max_depth : {FST::UNLIMITED_DEPTH, 3U})
+    {
+      // Create the FSTs
+      FST *fst = new FST(max_depth);
+      FST *suffix_array_fst = new FST(max_depth);
+      FST *expected_fst = new FST(max_depth);
+
+      // Add every string once with its weight resp. as often as its weight
+      for (unsigned int i = 0; i < strings.size(); i++)
+      {
+        fst->addString(strings[i], weights[i]);
+        for (unsigned int copy = 0; copy < weights[i]; copy++)
+          expected_fst->addString(strings[i]);
+      }
+      suffix_array_fst->addStrings(strings, weights, FST::SUFFIX_ARRAY);
+
+      // All FSTs should be equal
+      CHECK(*fst == *expected_fst);
+      CHECK(*suffix_array_fst == *expected_fst);
+      CHECK(fst->getNodeRepresentingSubstring("TATA")->getOverlaps() == 4);
+
+      // Clean up
+      delete fst;
+      delete suffix_array_fst;
+      delete expected_fst;
+    }
+  }
+
+  SUBCASE("Invalid weights")
+  {
+    // Create the FST
+    FST *fst = new FST();
+
+    CHECK_THROWS(fst->addStrings(strings, {1, 2}, FST::SUFFIX_TRIE));
+    CHECK_THROWS(fst->addStrings(strings, {1, 0, 1, 1}, FST::SUFFIX_TRIE));
+
+    // Clean up
+    delete fst;
+  }
+}
+
+TEST_CASE("Check if removing a string undoes adding it")
+{
+  vector<string_view> strings = {"TESTESTE", "TEST", "TATATA", "ATTEST", "AAAA"};
+
+  SUBCASE("Removing strings in any order")
+  {
+    for (unsigned int max_depth : {FST::UNLIMITED_DEPTH, 3U})
+    {
+      // Create the FSTs
+      FST *fst = new FST(max_depth);
+      FST *expected_fst = new FST(max_depth);
+
+      // Add all strings, but only the ones kept to the expected FST
+      for (unsigned int i = 0; i < strings.size(); i++)
+      {
+        fst->addString(strings[i], 2);
+        expected_fst->addString(strings[i], i % 2 == 0 ? 1 : 2);
+      }
+
+      // Remove one copy of the strings with an even index (backwards)
+      for (unsigned int i = strings.size(); i-- > 0;)
+        if (i % 2 == 0)
+          fst->removeString(strings[i]);
+      CHECK(*fst == *expected_fst);
+
+      // Removing everything leaves an empty FST
+      for (unsigned int i = 0; i < strings.size(); i++)
+        fst->removeString(strings[i], i % 2 == 0 ? 1 : 2);
+      CHECK(fst->getNrPaths() == 0);
+      CHECK(*fst == FST(max_depth));
+
+      // Clean up
+      delete fst;
+      delete expected_fst;
+    }
+  }
+
+  SUBCASE("Strings that are not part of the FST")
+  {
+    // Create the FST
+    FST *fst = new FST();
+    fst->addString("TEST");
+
+    CHECK_THROWS_AS(fst->removeString("TESTS"), runtime_error);
+    CHECK_THROWS_AS(fst->removeString("X"), runtime_error);
+
+    // The FST is unchanged
+    FST expected_fst;
+    expected_fst.addString("TEST");
+    CHECK(*fst == expected_fst);
+
+    // Clean up
+    delete fst;
+  }
+}
+
 TEST_CASE("Big integration TEST with addStrings and getDictionaryEntries")
 {
   SUBCASE("Sample of 100 Strings from the dbtext/city database (1)")
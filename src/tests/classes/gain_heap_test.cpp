@@ -0,0 +1,56 @@
+// Library includes
+using namespace std;
+#include <iostream>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../classes/gain_heap.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are focussed on testing the functionality of the class as a whole
+
+TEST_CASE("Check if the gain heap keeps the node with the highest gain on top")
+{
+  SUBCASE("Push, update and remove ids")
+  {
+    // Create the heap
+    GainHeap heap(8);
+    CHECK(heap.isEmpty());
+
+    // Push some ids with their gains (ids 2 and 5 share the highest gain)
+    heap.push(0, 3, 0);
+    heap.push(5, 10, 4);
+    heap.push(2, 10, 1);
+    heap.push(7, -1, 2);
+    CHECK(heap.getSize() == 4);
+    CHECK(heap.contains(5));
+    CHECK(!heap.contains(1));
+
+    // Equal gains are decided by the rank
+    CHECK(heap.getTop() == 2);
+
+    // Lowering the gain of the top moves the next id up
+    heap.update(2, 1);
+    CHECK(heap.getTop() == 5);
+    CHECK(heap.getGain(2) == 1);
+
+    // Raising the gain of an id moves it to the top
+    heap.update(7, 20);
+    CHECK(heap.getTop() == 7);
+
+    // Removed ids are no longer contained
+    heap.remove(7);
+    heap.remove(7);
+    CHECK(!heap.contains(7));
+    CHECK(heap.getTop() == 5);
+    heap.remove(5);
+    CHECK(heap.getTop() == 0);
+    heap.remove(0);
+    heap.remove(2);
+    CHECK(heap.isEmpty());
+  }
+}
@@ -0,0 +1,95 @@
+// Library includes
+using namespace std;
+#include <iostream>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../classes/fst.h"
+#include "../../classes/gain_model.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are focussed on testing the functionality of the class as a whole
+
+TEST_CASE("Check if the gain models rate the nodes correctly")
+{
+  // Create the FST
+  FST *fst = new FST();
+  fst->addString("abcabcab");
+
+  // "abc" occurs twice without overlaps, "ab" three times
+  Node *abc = fst->getNodeRepresentingSubstring("abc");
+  Node *ab = fst->getNodeRepresentingSubstring("ab");
+
+  SUBCASE("The default model is the gain of the node")
+  {
+    const GainModel &model = GainModel::getDefault();
+    CHECK(model.getGain(abc) == abc->getGain());
+    CHECK(model.getEntryCost(abc) == 0);
+    CHECK(model.getNetGain(ab) == ab->getGain());
+  }
+
+  SUBCASE("The code model charges one code per replaced occurrence")
+  {
+    CodeGainModel fsst(CodeGainModel::FSST_CODE_WIDTH);
+    CHECK(fsst.getGain(abc) == 2 * (24 - 8));
+    CHECK(fsst.getGain(ab) == 3 * (16 - 8));
+    CHECK(fsst.getNetGain(ab) == 24);
+
+    CodeGainModel fsst12(CodeGainModel::FSST12_CODE_WIDTH);
+    CHECK(fsst12.getGain(abc) == 2 * (24 - 12));
+    CHECK(fsst12.getGain(ab) == 3 * (16 - 12));
+  }
+
+  SUBCASE("The header cost is charged per byte of the entry")
+  {
+    CodeGainModel model(CodeGainModel::FSST_CODE_WIDTH, true);
+    CHECK(model.getEntryCost(abc) == 24);
+    CHECK(model.getNetGain(abc) == 2 * (24 - 8) - 24);
+    CHECK(model.getNetGain(ab) == 3 * (16 - 8) - 16);
+  }
+
+  // Clean up
+  delete fst;
+}
+
+TEST_CASE("Check if the FST selects its dictionary entries with its gain model")
+{
+  SUBCASE("Only entries with a positive net gain are selected")
+  {
+    // Create the FST
+    FST *fst = new FST();
+    fst->addString("abcdabcdabcdxyz");
+
+    // Every symbol of "xyz" occurs once and never pays for its entry
+    CodeGainModel model(CodeGainModel::FSST_CODE_WIDTH, true);
+    fst->setGainModel(&model);
+    CHECK(fst->getGainModel() == &model);
+
+    list<string> entries = fst->getDictionaryEntries(255, 7);
+    CHECK(!entries.empty());
+    CHECK(entries.size() < 255);
+    CHECK(entries.front() == "abcd");
+    for (string entry : entries)
+      CHECK(entry.find_first_of("xyz") == string::npos);
+
+    // Clean up
+    delete fst;
+  }
+
+  SUBCASE("Resetting the model restores the default")
+  {
+    // Create the FST
+    FST *fst = new FST();
+    CodeGainModel model;
+    fst->setGainModel(&model);
+    fst->setGainModel(NULL);
+    CHECK(fst->getGainModel() == &GainModel::getDefault());
+
+    // Clean up
+    delete fst;
+  }
+}
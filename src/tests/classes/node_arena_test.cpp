@@ -0,0 +1,164 @@
+// Library includes
+using namespace std;
+#include <iostream>
+#include <string>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../classes/node.h"
+#include "../../classes/node_arena.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are focussed on testing the functionality of the class as a whole
+
+TEST_CASE("Check if nodes are stored in and released to the arena correctly")
+{
+  SUBCASE("Nodes of a tree share the arena of their root")
+  {
+    // Create the root node in an arena
+    NodeArena *arena = new NodeArena();
+    Node *root = arena->createNode('T', 0, 0, NULL);
+
+    // Add a string to the tree
+    root->addSubstring("TEST");
+
+    // Get the different nodes
+    Node *e_node = root->getChild('E');
+    Node *t_node = e_node->getChild('S')->getChild('T');
+
+    // Check if all nodes are stored in the same arena
+    CHECK(root->getArena() == arena);
+    CHECK(e_node->getArena() == arena);
+    CHECK(t_node->getArena() == arena);
+    CHECK(arena->getNrNodes() == 4);
+
+    // Check if the ids resolve to the nodes
+    CHECK(arena->getNode(root->getId()) == root);
+    CHECK(arena->getNode(e_node->getId()) == e_node);
+    CHECK(arena->getNode(t_node->getId()) == t_node);
+
+    // Clean up
+    delete arena;
+  }
+
+  SUBCASE("Released slots are reused")
+  {
+    // Create the root node in an arena
+    NodeArena *arena = new NodeArena();
+    Node *root = arena->createNode('T', 0, 0, NULL);
+
+    // Add a string to the tree and subtract it again
+    root->addSubstring("TEST");
+    root->addSubstring("TE");
+    root->subtractSubstring("TEST");
+
+    // Only the root and the E node should be left
+    CHECK(arena->getNrNodes() == 2);
+    CHECK(arena->getCapacity() == 4);
+
+    // Adding the substring again should not need new slots
+    root->addSubstring("TEST");
+    CHECK(arena->getNrNodes() == 4);
+    CHECK(arena->getCapacity() == 4);
+
+    // Clean up
+    delete arena;
+  }
+
+  SUBCASE("Standalone trees share an arena and release their nodes on delete")
+  {
+    // Create two standalone trees
+    Node *root1 = Node::create('T', 0, 0, NULL);
+    Node *root2 = Node::create('A', 0, 0, NULL);
+    root1->addSubstring("TEST");
+    root2->addSubstring("AB");
+
+    // Both are stored in the same arena
+    NodeArena *arena = root1->getArena();
+    CHECK(root2->getArena() == arena);
+    unsigned int nr_nodes = arena->getNrNodes();
+
+    // Deleting a root releases its whole tree, the other tree stays intact
+    delete root1;
+    CHECK(arena->getNrNodes() == nr_nodes - 4);
+    CHECK(root2->getChild('B')->getFrequency() == 1);
+
+    // Children are created in the arena of their parent
+    Node *child = Node::create('C', 1, 1, root2);
+    CHECK(child->getArena() == arena);
+    CHECK(child->getParent() == root2);
+    CHECK(root2->getChild('C') == child);
+
+    // Clean up
+    delete root2;
+    CHECK(arena->getNrNodes() == nr_nodes - 6);
+  }
+
+  SUBCASE("Trees larger than a single chunk")
+  {
+    // Create an arena
+    NodeArena *arena = new NodeArena();
+
+    // Create a chain of nodes spanning multiple chunks
+    Node *root = arena->createNode('A', 1, 0, NULL);
+    Node *node = root;
+    for (unsigned int i = 1; i < NodeArena::NODES_PER_CHUNK + 10; i++)
+      node = arena->createNode('A', 1, i, node);
+
+    // Check if the ids of all nodes resolve correctly
+    CHECK(arena->getNrNodes() == NodeArena::NODES_PER_CHUNK + 10);
+    CHECK(arena->getNode(node->getId()) == node);
+    CHECK(node->getArena() == arena);
+    CHECK(node->getParent()->getLevel() == NodeArena::NODES_PER_CHUNK + 8);
+
+    // Clean up
+    delete arena;
+  }
+
+  SUBCASE("Values that do not fit into their narrow field")
+  {
+    // Create the root node
+    Node *root = Node::create('T', 0, 0, NULL);
+    root->addSubstring("TE");
+    Node *e_node = root->getChild('E');
+
+    // Counters beyond 16 bits are stored wide
+    e_node->raiseFrequency(70000);
+    e_node->raiseOverlaps(65535);
+    CHECK(e_node->getFrequency() == 70001);
+    CHECK(e_node->getOverlaps() == 65535);
+
+    // And narrow again when they fit
+    e_node->lowerFrequency(70000);
+    e_node->lowerOverlaps(65000);
+    CHECK(e_node->getFrequency() == 1);
+    CHECK(e_node->getOverlaps() == 535);
+
+    // Clean up
+    delete root;
+  }
+
+  SUBCASE("Reused slots do not keep the wide values of released nodes")
+  {
+    // Create an arena
+    NodeArena *arena = new NodeArena();
+
+    // Create a node with wide values and release it
+    Node *node = arena->createNode('A', 100000, 300, NULL);
+    CHECK(node->getLevel() == 300);
+    arena->releaseSubtree(node->getId());
+
+    // The next node is created in the same slot
+    Node *reused = arena->createNode('B', 1, 1, NULL);
+    CHECK(reused == node);
+    CHECK(reused->getFrequency() == 1);
+    CHECK(reused->getLevel() == 1);
+
+    // Clean up
+    delete arena;
+  }
+}
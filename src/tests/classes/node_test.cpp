@@ -22,7 +22,7 @@ TEST_CASE("Check if a tree can be build by creating a root node and adding "
   SUBCASE("TEST")
   {
     // Create the root node
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add a string to the tree
     root->addSubstring("TEST");
@@ -51,7 +51,7 @@ TEST_CASE("Check if a tree can be build by creating a root node and adding "
   SUBCASE("TEST and TARGET")
   {
     // Create the root node
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add a string to the tree
     root->addSubstring("TEST");
@@ -101,7 +101,7 @@ TEST_CASE("Check if a node returns the substrings it represents correctly")
   SUBCASE("TEST")
   {
     // Create the root node
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add a string to the tree
     root->addSubstring("TEST");
@@ -127,7 +127,7 @@ TEST_CASE("Check if a node returns its root node correctly")
   SUBCASE("TEST")
   {
     // Create the root node
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add a string to the tree
     root->addSubstring("TEST");
@@ -153,7 +153,7 @@ TEST_CASE("Check if a node representing a substring is correctly identified")
   SUBCASE("TEST")
   {
     // Create the root node
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add a string to the tree
     root->addSubstring("TEST");
@@ -181,7 +181,7 @@ TEST_CASE("Check if overlaps are added correctly")
   SUBCASE("TESTESTE")
   {
     // Create the root node
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add a string to the tree
     root->addSubstring("TESTESTE");
@@ -218,7 +218,7 @@ TEST_CASE("Check if represented substrings are returned correctly")
   SUBCASE("TEST and TESTESTE")
   {
     // Create the root node
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("TEST");
@@ -340,7 +340,7 @@ TEST_CASE("Check if represented substrings are returned correctly")
   SUBCASE("TEST and TARGET")
   {
     // Create the root node
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("TEST");
@@ -447,6 +447,17 @@ TEST_CASE("Check if represented substrings are returned correctly")
                  "TARGET") != represented_strings.end());
     }
 
+    SUBCASE("Counts")
+    {
+      // Every distinct substring is returned once with its number of copies
+      string buffer;
+      vector<pair<string_view, unsigned int>> represented_strings =
+          root->getRepresentedSubstringCounts(buffer);
+      CHECK(represented_strings ==
+            vector<pair<string_view, unsigned int>>(
+                {{"TEST", 1}, {"TARGET", 1}, {"T", 2}}));
+    }
+
     // Clean up
     delete root;
   }
@@ -457,14 +468,14 @@ TEST_CASE("Check if equal trees are correctly identified")
   SUBCASE("Two equal trees with strings TEST and TARGET")
   {
     // Create the first tree
-    Node *root1 = new Node('T', 0, 0, NULL);
+    Node *root1 = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root1->addSubstring("TEST");
     root1->addSubstring("TARGET");
 
     // Create the second tree
-    Node *root2 = new Node('T', 0, 0, NULL);
+    Node *root2 = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root2->addSubstring("TEST");
@@ -482,14 +493,14 @@ TEST_CASE("Check if equal trees are correctly identified")
       "Two unequal trees with strings TEST and TARGET resp. TEST and TARG")
   {
     // Create the first tree
-    Node *root1 = new Node('T', 0, 0, NULL);
+    Node *root1 = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root1->addSubstring("TEST");
     root1->addSubstring("TARGET");
 
     // Create the second tree
-    Node *root2 = new Node('T', 0, 0, NULL);
+    Node *root2 = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root2->addSubstring("TEST");
@@ -510,14 +521,14 @@ TEST_CASE("Check if unequal trees are correctly identified")
       "Two unequal trees with strings TEST and TARGET resp. TEST and TARG")
   {
     // Create the first tree
-    Node *root1 = new Node('T', 0, 0, NULL);
+    Node *root1 = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root1->addSubstring("TEST");
     root1->addSubstring("TARGET");
 
     // Create the second tree
-    Node *root2 = new Node('T', 0, 0, NULL);
+    Node *root2 = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root2->addSubstring("TEST");
@@ -534,14 +545,14 @@ TEST_CASE("Check if unequal trees are correctly identified")
   SUBCASE("Two equal trees with strings TEST and TARGET")
   {
     // Create the first tree
-    Node *root1 = new Node('T', 0, 0, NULL);
+    Node *root1 = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root1->addSubstring("TEST");
     root1->addSubstring("TARGET");
 
     // Create the second tree
-    Node *root2 = new Node('T', 0, 0, NULL);
+    Node *root2 = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root2->addSubstring("TEST");
@@ -563,7 +574,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
       "Tree with strings ATTEST and ACADEMIC where TEST should be deleted")
   {
     // Create the tree
-    Node *root = new Node('A', 0, 0, NULL);
+    Node *root = Node::create('A', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("ATTEST");
@@ -573,7 +584,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
     root->deleteFullStringOccurrences("TEST");
 
     // Create the validation tree
-    Node *validation_root = new Node('A', 0, 0, NULL);
+    Node *validation_root = Node::create('A', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     validation_root->addSubstring("AT");
@@ -591,7 +602,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
       "Tree with strings TEST, TESTER and TEMPO where TEST should be deleted")
   {
     // Create the tree
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("TEST");
@@ -602,7 +613,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
     root->deleteFullStringOccurrences("TEST");
 
     // Create the validation tree
-    Node *validation_root = new Node('T', 0, 0, NULL);
+    Node *validation_root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     validation_root->addSubstring("TEMPO");
@@ -618,7 +629,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
   SUBCASE("Tree with strings T, TEST and TTEST where TEST should be deleted")
   {
     // Create the tree
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("T");
@@ -629,7 +640,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
     root->deleteFullStringOccurrences("TEST");
 
     // Create the validation tree
-    Node *validation_root = new Node('T', 0, 0, NULL);
+    Node *validation_root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     validation_root->addSubstring("T");
@@ -647,7 +658,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
           "should be deleted")
   {
     // Create the tree
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("TE");
@@ -660,7 +671,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
     root->deleteFullStringOccurrences("ESTI");
 
     // Create the validation tree
-    Node *validation_root = new Node('T', 0, 0, NULL);
+    Node *validation_root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     validation_root->addSubstring("TE");
@@ -682,7 +693,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
           "TON should be deleteted")
   {
     // Create the tree
-    Node *root = new Node('A', 0, 0, NULL);
+    Node *root = Node::create('A', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("A DUNES");
@@ -762,7 +773,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
     root->deleteFullStringOccurrences("TON");
 
     // Create the validation tree
-    Node *validation_root = new Node('A', 0, 0, NULL);
+    Node *validation_root = Node::create('A', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     validation_root->addSubstring("A DUNES");
@@ -869,7 +880,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
           " PARK should be deleteted")
   {
     // Create the tree
-    Node *root = new Node('N', 0, 0, NULL);
+    Node *root = Node::create('N', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("NT WASHINGTON");
@@ -948,7 +959,7 @@ TEST_CASE("Check if full occurrences of a string within a tree are deleted "
     root->deleteFullStringOccurrences(" PARK");
 
     // Create the validation tree
-    Node *validation_root = new Node('N', 0, 0, NULL);
+    Node *validation_root = Node::create('N', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     validation_root->addSubstring("NT WASHINGTON");
@@ -1037,7 +1048,7 @@ TEST_CASE("Check if substrings are correctly subtracted from the tree")
   SUBCASE("Tree with strings TEST and TEMPO where TEST should be deleted")
   {
     // Create the tree
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("TEST");
@@ -1047,7 +1058,7 @@ TEST_CASE("Check if substrings are correctly subtracted from the tree")
     root->subtractSubstring("TEST");
 
     // Create the validation tree
-    Node *validation_root = new Node('T', 0, 0, NULL);
+    Node *validation_root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     validation_root->addSubstring("TEMPO");
@@ -1064,7 +1075,7 @@ TEST_CASE("Check if substrings are correctly subtracted from the tree")
       "Tree with strings TEST, TESTER and TEMPO where TEST should be deleted")
   {
     // Create the tree
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("TEST");
@@ -1075,7 +1086,7 @@ TEST_CASE("Check if substrings are correctly subtracted from the tree")
     root->subtractSubstring("TEST");
 
     // Create the validation tree
-    Node *validation_root = new Node('T', 0, 0, NULL);
+    Node *validation_root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     validation_root->addSubstring("TEMPO");
@@ -1093,7 +1104,7 @@ TEST_CASE("Check if substrings are correctly subtracted from the tree")
           "(exception expected)")
   {
     // Create the tree
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("TEST");
@@ -1103,7 +1114,7 @@ TEST_CASE("Check if substrings are correctly subtracted from the tree")
     CHECK_THROWS(root->subtractSubstring("DOMINIK"));
 
     // Create the validation tree
-    Node *validation_root = new Node('T', 0, 0, NULL);
+    Node *validation_root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     validation_root->addSubstring("TEMPO");
@@ -1121,7 +1132,7 @@ TEST_CASE("Check if substrings are correctly subtracted from the tree")
           "(exception expected)")
   {
     // Create the tree
-    Node *root = new Node('T', 0, 0, NULL);
+    Node *root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     root->addSubstring("TEST");
@@ -1131,7 +1142,7 @@ TEST_CASE("Check if substrings are correctly subtracted from the tree")
     CHECK_THROWS(root->subtractSubstring("TESTER"));
 
     // Create the validation tree
-    Node *validation_root = new Node('T', 0, 0, NULL);
+    Node *validation_root = Node::create('T', 0, 0, NULL);
 
     // Add the strings themselves to the tree
     validation_root->addSubstring("TEMPO");
@@ -1144,4 +1155,69 @@ TEST_CASE("Check if substrings are correctly subtracted from the tree")
     delete root;
     delete validation_root;
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Check if the tree is traversed correctly")
+{
+  // Create the tree
+  Node *root = Node::create('T', 0, 0, NULL);
+  root->addSubstring("TEST");
+  root->addSubstring("TEAM");
+
+  SUBCASE("All nodes are visited in pre-order with their substrings")
+  {
+    list<string> substrings;
+    root->visit(
+        [&](Node *node, string_view substring)
+        {
+          CHECK(node->getSubstring() == substring);
+          substrings.emplace_back(substring);
+          return true;
+        });
+
+    CHECK(substrings == list<string>({"T", "TE", "TES", "TEST", "TEA", "TEAM"}));
+  }
+
+  SUBCASE("Subtrees are skipped if the visitor returns false")
+  {
+    list<string> substrings;
+    root->visit(
+        [&](Node *, string_view substring)
+        {
+          substrings.emplace_back(substring);
+          return substring != "TEA";
+        });
+
+    CHECK(substrings == list<string>({"T", "TE", "TES", "TEST", "TEA"}));
+  }
+
+  SUBCASE("Nodes below the maximum level are not visited")
+  {
+    list<string> substrings;
+    root->visit(
+        [&](Node *, string_view substring)
+        {
+          substrings.emplace_back(substring);
+          return true;
+        },
+        2);
+
+    CHECK(substrings == list<string>({"T", "TE", "TES", "TEA"}));
+  }
+
+  SUBCASE("The post visitor sees the nodes after their descendants")
+  {
+    list<string> substrings;
+    root->traverse([](Node *, string_view) { return true; },
+                   [&](Node *node, string_view substring)
+                   {
+                     CHECK(node->getSubstring() == substring);
+                     substrings.emplace_back(substring);
+                   });
+
+    CHECK(substrings == list<string>({"TEST", "TES", "TEAM", "TEA", "TE", "T"}));
+  }
+
+  // Clean up
+  delete root;
+}
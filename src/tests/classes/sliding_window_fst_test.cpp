@@ -0,0 +1,67 @@
+// Library includes
+using namespace std;
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../classes/fst.h"
+#include "../../classes/sliding_window_fst.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are focussed on testing the functionality of the class as a whole
+
+TEST_CASE("Check if the window FST equals the FST of the last lines")
+{
+  SUBCASE("Random lines")
+  {
+    // Lines over a small alphabet (many shared substrings and overlaps)
+    mt19937 generator(42);
+    uniform_int_distribution<int> symbols(0, 2), lengths(1, 12);
+    vector<string> lines;
+    for (int i = 0; i < 60; i++)
+    {
+      string line;
+      for (int length = lengths(generator); length > 0; length--)
+        line.push_back("ab\xe4"[symbols(generator)]);
+      lines.push_back(line);
+    }
+
+    for (unsigned int max_depth : {FST::UNLIMITED_DEPTH, 4U})
+    {
+      SlidingWindowFST window(8, max_depth);
+      for (size_t i = 0; i < lines.size(); i++)
+      {
+        window.addLine(lines[i]);
+
+        // Build the FST of the window from scratch
+        FST expected_fst(max_depth);
+        for (size_t j = i < 8 ? 0 : i - 7; j <= i; j++)
+          expected_fst.addString(lines[j]);
+
+        CHECK(window.getNrLines() == min<size_t>(i + 1, 8));
+        CHECK(window.getFST() == expected_fst);
+        if (i % 10 == 0)
+          CHECK(window.getDictionaryEntries(10, 4) ==
+                expected_fst.getDictionaryEntries(10, 4));
+      }
+
+      // Clearing the window leaves an empty FST
+      window.clear();
+      CHECK(window.getNrLines() == 0);
+      CHECK(window.getFST().getNrPaths() == 0);
+    }
+  }
+
+  SUBCASE("A window without lines")
+  {
+    CHECK_THROWS_AS(SlidingWindowFST(0), invalid_argument);
+  }
+}
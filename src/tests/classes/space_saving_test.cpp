@@ -0,0 +1,117 @@
+// Library includes
+using namespace std;
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../classes/fst.h"
+#include "../../classes/space_saving.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are focussed on testing the functionality of the class as a whole
+
+TEST_CASE("Check if the counts are exact while all substrings fit")
+{
+  SUBCASE("Strings TESTESTE, TATATA and AAAA")
+  {
+    SpaceSaving counter(1000);
+    FST fst(7);
+    for (string str : {"TESTESTE", "TATATA", "AAAA"})
+    {
+      counter.addString(str, 2);
+      fst.addString(str, 2);
+    }
+
+    // Every substring of 2 to 8 bytes is counted like in the FST
+    vector<SpaceSaving::HeavyHitter> heavy_hitters = counter.getHeavyHitters();
+    for (const SpaceSaving::HeavyHitter &heavy_hitter : heavy_hitters)
+    {
+      Node *node = fst.getNodeRepresentingSubstring(heavy_hitter.substring);
+      REQUIRE(node != NULL);
+      CHECK(heavy_hitter.frequency == node->getFrequency());
+      CHECK(heavy_hitter.overlaps == node->getOverlaps());
+      CHECK(heavy_hitter.error == 0);
+    }
+    CHECK(heavy_hitters.front().substring == "AA");
+    CHECK(heavy_hitters.front().frequency == 6);
+    CHECK(counter.getByteFrequency('A') == 14);
+    CHECK(counter.getNrBytes() == 36);
+  }
+}
+
+TEST_CASE("Check if the counts are bounded once substrings are replaced")
+{
+  SUBCASE("Random strings with frequent words")
+  {
+    // Strings mixing a few frequent words with random bytes
+    mt19937 generator(42);
+    uniform_int_distribution<int> bytes(0, 255), words(0, 5), lengths(0, 6);
+    vector<string> frequent = {"http://", ".com", "www."};
+    vector<string> strings;
+    for (int i = 0; i < 400; i++)
+    {
+      string str;
+      for (int part = 0; part < 4; part++)
+      {
+        int word = words(generator);
+        if (word < 3)
+          str += frequent[word];
+        for (int length = lengths(generator); length > 0; length--)
+          str.push_back((char)bytes(generator));
+      }
+      strings.push_back(str);
+    }
+
+    // Count the substrings exactly
+    map<string, uint64_t> frequencies;
+    uint64_t nr_occurrences = 0;
+    for (const string &str : strings)
+      for (size_t i = 0; i < str.length(); i++)
+        for (size_t length = 2; length <= 8 && i + length <= str.length();
+             length++)
+        {
+          frequencies[str.substr(i, length)]++;
+          nr_occurrences++;
+        }
+
+    SpaceSaving counter(200);
+    for (const string &str : strings)
+      counter.addString(str);
+
+    // The memory is bounded and every count is within its error
+    vector<SpaceSaving::HeavyHitter> heavy_hitters = counter.getHeavyHitters();
+    CHECK(heavy_hitters.size() == 200);
+    map<string, bool> kept;
+    for (const SpaceSaving::HeavyHitter &heavy_hitter : heavy_hitters)
+    {
+      uint64_t frequency = frequencies[heavy_hitter.substring];
+      CHECK(heavy_hitter.frequency >= frequency);
+      CHECK(heavy_hitter.frequency - heavy_hitter.error <= frequency);
+      CHECK(heavy_hitter.error <= nr_occurrences / 200);
+      kept[heavy_hitter.substring] = true;
+    }
+
+    // Every substring occurring more often than the maximum error is kept
+    for (const pair<const string, uint64_t> &frequency : frequencies)
+      if (frequency.second > nr_occurrences / 200)
+        CHECK(kept[frequency.first]);
+    CHECK(kept["http://"]);
+    CHECK(kept[".com"]);
+  }
+
+  SUBCASE("Invalid parameters")
+  {
+    CHECK_THROWS_AS(SpaceSaving(0), invalid_argument);
+    CHECK_THROWS_AS(SpaceSaving(10, 1, 8), invalid_argument);
+    CHECK_THROWS_AS(SpaceSaving(10, 4, 3), invalid_argument);
+    CHECK_THROWS_AS(SpaceSaving(10, 2, 9), invalid_argument);
+  }
+}
@@ -0,0 +1,81 @@
+// Library includes
+using namespace std;
+#include <iostream>
+#include <string>
+#include <utility>
+#include <string_view>
+#include <vector>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../classes/suffix_array.h"
+
+// ---------------------------------------------------------------------------------------------
+// Class-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are focussed on testing the functionality of the class as a whole
+
+TEST_CASE("Check if the suffixes of multiple strings are sorted correctly")
+{
+  SUBCASE("Strings TESTE and EST")
+  {
+    // Create the suffix array
+    SuffixArray suffix_array({"TESTE", "EST"});
+
+    // Both separators come first, followed by the sorted suffixes
+    vector<string> expected_order = {"",    "",   "E",  "EST", "ESTE",
+                                     "ST",  "STE", "T", "TE",  "TESTE"};
+    REQUIRE(suffix_array.getNrSuffixes() == 10);
+    for (unsigned int i = 0; i < suffix_array.getNrSuffixes(); i++)
+    {
+      string suffix;
+      for (unsigned int j = 0; j < suffix_array.getLength(i); j++)
+        suffix += suffix_array.getSymbol(suffix_array.getPosition(i) + j);
+      CHECK(suffix == expected_order[i]);
+    }
+
+    // The common prefixes never reach across a separator
+    CHECK(suffix_array.getLcp(3) == 1);
+    CHECK(suffix_array.getLcp(4) == 3);
+    CHECK(suffix_array.getLcp(9) == 2);
+  }
+
+  SUBCASE("Overlapping occurrences of TT and TATA")
+  {
+    // Create the suffix array with suffixes truncated to 4 symbols
+    SuffixArray suffix_array({"TTTT", "TATATA", "TT"}, 4);
+
+    // Find the ranks of the suffixes starting with a substring
+    auto find = [&suffix_array](string substring) {
+      unsigned int first = suffix_array.getNrSuffixes();
+      unsigned int last = 0;
+      for (unsigned int i = 0; i < suffix_array.getNrSuffixes(); i++)
+      {
+        string suffix;
+        for (unsigned int j = 0; j < suffix_array.getLength(i); j++)
+          suffix += suffix_array.getSymbol(suffix_array.getPosition(i) + j);
+        if (suffix.compare(0, substring.length(), substring) == 0)
+        {
+          first = min(first, i);
+          last = i + 1;
+        }
+      }
+      return make_pair(first, last);
+    };
+
+    // TT occurs 4 times, 3 of them can be replaced (TT|TT and TT)
+    pair<unsigned int, unsigned int> tt = find("TT");
+    CHECK(tt.second - tt.first == 4);
+    CHECK(suffix_array.getNrOverlaps(tt.first, tt.second, 2) == 1);
+
+    // TATA occurs twice within the same string, but only once replaceable
+    pair<unsigned int, unsigned int> tata = find("TATA");
+    CHECK(suffix_array.getNrOverlaps(tata.first, tata.second, 4) == 1);
+
+    // AT cannot overlap itself
+    pair<unsigned int, unsigned int> at = find("AT");
+    CHECK(suffix_array.getNrOverlaps(at.first, at.second, 2) == 0);
+  }
+}
@@ -0,0 +1,52 @@
+# Test of the adaptive mode of fsst_with_fst (run by ctest with cmake -P)
+#
+# Compresses the same input twice with -a. The input consists of blocks of
+# two different columns, so tables are both reused and rebuilt. Both runs
+# have to write the same output and build the same number of symbol tables,
+# which has to be smaller than the number of blocks.
+#
+# Arguments:
+#   FSST_WITH_FST The path of the program
+#   DBTEXT        The directory of the dbtext columns
+#   WORK_DIR      The directory to write the files to
+
+# Build the input (about 20 MB, i.e. 5 blocks)
+file(MAKE_DIRECTORY ${WORK_DIR})
+set(input ${WORK_DIR}/input)
+file(WRITE ${input} "")
+foreach(column l_comment l_comment l_comment wiki wiki wiki l_comment l_comment)
+  file(READ ${DBTEXT}/${column} content)
+  file(APPEND ${input} "${content}")
+endforeach()
+set(nr_blocks 5)
+
+# Compress it twice
+foreach(run 1 2)
+  execute_process(COMMAND ${FSST_WITH_FST} -a 1000 ${input} ${WORK_DIR}/output_${run}
+                  RESULT_VARIABLE result
+                  OUTPUT_VARIABLE stdout_${run})
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Run ${run} failed: ${result}")
+  endif()
+  string(REGEX MATCH "Symbol tables built: ([0-9]+)" match "${stdout_${run}}")
+  if(NOT match)
+    message(FATAL_ERROR "Run ${run} did not report the symbol tables built")
+  endif()
+  set(tables_built_${run} ${CMAKE_MATCH_1})
+endforeach()
+
+# Both runs have to give the same result
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
+                        ${WORK_DIR}/output_1 ${WORK_DIR}/output_2
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "The outputs of both runs differ")
+endif()
+if(NOT tables_built_1 EQUAL tables_built_2)
+  message(FATAL_ERROR "The runs built ${tables_built_1} resp. ${tables_built_2} symbol tables")
+endif()
+
+# The tables were reused
+if(NOT tables_built_1 LESS nr_blocks)
+  message(FATAL_ERROR "Every block built its own symbol table (${tables_built_1})")
+endif()
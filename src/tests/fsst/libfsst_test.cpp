@@ -0,0 +1,275 @@
+// Library includes
+using namespace std;
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../../lib/fsst/fsst.h"
+#include "../../fsst/fsst.h"
+
+// ---------------------------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @brief Compresses strings with an encoder and decompresses them again with
+ * the decoder FSST exports for it (the encoder is destroyed).
+ * @param encoder The encoder.
+ * @param strings The strings (including their terminating zero byte, if any).
+ * @return The decompressed strings.
+ */
+static vector<string> round_trip(fsst_encoder_t *encoder,
+                                 const vector<string> &strings)
+{
+  // Compress the strings
+  vector<size_t> lens;
+  vector<unsigned char *> strs;
+  size_t total = 0;
+  for (const string &str : strings)
+  {
+    lens.push_back(str.size());
+    strs.push_back((unsigned char *)str.data());
+    total += str.size();
+  }
+  vector<unsigned char> output(7 + 2 * total);
+  vector<size_t> lenOut(strings.size());
+  vector<unsigned char *> strOut(strings.size());
+  size_t compressed =
+      fsst_compress(encoder, strings.size(), lens.data(), strs.data(),
+                    output.size(), output.data(), lenOut.data(), strOut.data());
+  REQUIRE(compressed == strings.size());
+
+  // Decompress them through an exported and imported symbol table
+  unsigned char header[FSST_MAXHEADER];
+  fsst_export(encoder, header);
+  fsst_decoder_t decoder;
+  fsst_import(&decoder, header);
+  fsst_destroy(encoder);
+
+  vector<string> decompressed;
+  for (size_t i = 0; i < strings.size(); i++)
+  {
+    vector<unsigned char> buffer(strings[i].size() + 64);
+    size_t len = fsst_decompress(&decoder, lenOut[i], strOut[i],
+                                 buffer.size(), buffer.data());
+    decompressed.emplace_back((const char *)buffer.data(), len);
+  }
+  return decompressed;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Function-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are foccused on testing the functionality of a single function
+
+TEST_CASE("fsst_create_with_fst_from_strings")
+{
+  // Build strings with frequent substrings (and some rare bytes)
+  vector<string> strings;
+  for (unsigned int i = 0; i < 300; i++)
+    strings.push_back("https://www." + string(i % 4, 'w') + "example" +
+                      to_string(i * 7919 % 1000) + ".com/index.html" +
+                      (i % 50 == 0 ? "\xff\x01" : ""));
+  strings.push_back("");
+
+  SUBCASE("Strings that are not zero-terminated")
+  {
+    vector<size_t> lens;
+    vector<unsigned char *> strs;
+    for (string &str : strings)
+    {
+      lens.push_back(str.size());
+      strs.push_back((unsigned char *)str.data());
+    }
+
+    for (FST::CountingBackend backend :
+         {FST::SUFFIX_TRIE, FST::SUFFIX_ARRAY, FST::SPACE_SAVING})
+    {
+      fsst_encoder_t *encoder = fsst_create_with_fst_from_strings(
+          strings.size(), lens.data(), strs.data(), 0, 7, backend);
+      CHECK(round_trip(encoder, strings) == strings);
+    }
+  }
+
+  SUBCASE("Zero-terminated strings")
+  {
+    // The terminating zero byte belongs to every string
+    vector<string> terminated;
+    for (const string &str : strings)
+      terminated.push_back(str + '\0');
+
+    vector<size_t> lens;
+    vector<unsigned char *> strs;
+    for (string &str : terminated)
+    {
+      lens.push_back(str.size());
+      strs.push_back((unsigned char *)str.data());
+    }
+
+    fsst_encoder_t *encoder = fsst_create_with_fst_from_strings(
+        terminated.size(), lens.data(), strs.data(), 1);
+    CHECK(round_trip(encoder, terminated) == terminated);
+  }
+
+  SUBCASE("Compression pays off")
+  {
+    vector<size_t> lens;
+    vector<unsigned char *> strs;
+    size_t total = 0;
+    for (string &str : strings)
+    {
+      lens.push_back(str.size());
+      strs.push_back((unsigned char *)str.data());
+      total += str.size();
+    }
+
+    fsst_encoder_t *encoder = fsst_create_with_fst_from_strings(
+        strings.size(), lens.data(), strs.data(), 0);
+    vector<unsigned char> output(7 + 2 * total);
+    vector<size_t> lenOut(strings.size());
+    vector<unsigned char *> strOut(strings.size());
+    fsst_compress(encoder, strings.size(), lens.data(), strs.data(),
+                  output.size(), output.data(), lenOut.data(), strOut.data());
+    size_t compressed_total = 0;
+    for (size_t len : lenOut)
+      compressed_total += len;
+    CHECK(compressed_total < total / 2);
+    fsst_destroy(encoder);
+  }
+}
+
+TEST_CASE("create_encoder_from_fst")
+{
+  // Get the size of a single string compressed by an encoder
+  auto compressed_size = [](fsst_encoder_t *encoder, string str)
+  {
+    size_t len = str.size();
+    unsigned char *data = (unsigned char *)str.data();
+    vector<unsigned char> output(7 + 2 * len);
+    size_t lenOut;
+    unsigned char *strOut;
+    fsst_compress(encoder, 1, &len, &data, output.size(), output.data(),
+                  &lenOut, &strOut);
+    return lenOut;
+  };
+
+  // Build the FST of a sample with 251 bytes saving 20 bytes each, X saving
+  // 30 bytes and Z saving 11 bytes, so W and the entry XY compete for the last
+  // free code (zero-terminated strings leave 254 codes)
+  auto create_fst = [](unsigned int xy_weight)
+  {
+    FST *fst = new FST(7);
+    for (unsigned int byte = 1; byte < 256; byte++)
+      if (string("WXYZ").find((char)byte) == string::npos)
+        fst->addString(string(1, (char)byte), 20);
+    fst->addString(string_view("X"), 30);
+    fst->addString(string_view("Z"), 11);
+    fst->addString(string_view("W"), 9);
+    fst->addString(string_view("XY"), xy_weight);
+    return fst;
+  };
+  u64 byte_histo[256] = {0};
+
+  SUBCASE("An entry saving more bytes than a single byte")
+  {
+    // XY saves 10 bytes, W only 9
+    fsst_encoder_t *encoder = create_encoder_from_fst(create_fst(10),
+                                                      byte_histo, 1);
+    CHECK(compressed_size(encoder, "XY") == 1);
+    CHECK(compressed_size(encoder, "Z") == 1);
+    CHECK(compressed_size(encoder, "W") == 2);
+    CHECK(round_trip(encoder, {string("WXYZ\0", 5), string("XYXY\0", 5)}) ==
+          vector<string>{string("WXYZ\0", 5), string("XYXY\0", 5)});
+  }
+
+  SUBCASE("A frequent single byte saving more bytes than a rare entry")
+  {
+    // XY saves 2 bytes, W 9 (Y only occurs within XY, so it is escaped)
+    fsst_encoder_t *encoder = create_encoder_from_fst(create_fst(2),
+                                                      byte_histo, 1);
+    CHECK(compressed_size(encoder, "XY") == 3);
+    CHECK(compressed_size(encoder, "W") == 1);
+    CHECK(compressed_size(encoder, "Z") == 1);
+    CHECK(round_trip(encoder, {string("WXYZ\0", 5), string("XYXY\0", 5)}) ==
+          vector<string>{string("WXYZ\0", 5), string("XYXY\0", 5)});
+  }
+
+  SUBCASE("Entries containing the terminator are skipped")
+  {
+    // The zero byte is the least frequent byte, so it terminates the strings
+    FST *fst = new FST(7);
+    fst->addString(string_view("AB\0", 3), 50);
+    fst->addString(string_view("AB"), 50);
+    for (unsigned int byte = 1; byte < 256; byte++)
+      byte_histo[byte] = 1;
+
+    fsst_encoder_t *encoder = create_encoder_from_fst(fst, byte_histo, 0);
+    CHECK(compressed_size(encoder, "AB") == 1);
+    CHECK(compressed_size(encoder, string("AB\0", 3)) == 3);
+    CHECK(round_trip(encoder, {string("AB\0", 3), "AB", ""}) ==
+          vector<string>{string("AB\0", 3), "AB", ""});
+  }
+}
+
+TEST_CASE("fsst_probe_compression_ratio")
+{
+  // Build batches of lines, the first two similar to each other
+  auto make_batch = [](unsigned int offset, bool drifting)
+  {
+    string batch;
+    for (unsigned int i = offset; i < offset + 2000; i++)
+    {
+      if (!drifting)
+        batch += "https://www.example" + to_string(i * 7919 % 1000) +
+                 ".com/index.html\n";
+      else
+        batch += "{\"id\": " + to_string(i * 104729 % 100003) +
+                 ", \"status\": \"" + (i % 3 ? "active" : "deleted") + "\"}\n";
+    }
+    return batch;
+  };
+  string batch = make_batch(0, false);
+  string similar = make_batch(5000, false);
+  string drifting = make_batch(0, true);
+
+  // Build the symbol table on the first batch
+  size_t len = batch.size();
+  unsigned char *buf = (unsigned char *)batch.data();
+  fsst_encoder_t *encoder = fsst_create_with_fst(256, &len, &buf);
+  double table_ratio = fsst_probe_compression_ratio(
+      encoder, batch.size(), (unsigned char *)batch.data());
+  REQUIRE(table_ratio > 0);
+  CHECK(table_ratio < 0.5);
+
+  SUBCASE("The ratio stays below the threshold on similar data")
+  {
+    double ratio = fsst_probe_compression_ratio(
+        encoder, similar.size(), (unsigned char *)similar.data());
+    CHECK(ratio <= table_ratio * 1.1);
+  }
+
+  SUBCASE("The ratio rises on drifting data")
+  {
+    double ratio = fsst_probe_compression_ratio(
+        encoder, drifting.size(), (unsigned char *)drifting.data());
+    CHECK(ratio > table_ratio * 1.1);
+    CHECK(ratio > 1);
+  }
+
+  SUBCASE("The probe is reproducible and bounded by its budget")
+  {
+    CHECK(fsst_probe_compression_ratio(encoder, batch.size(),
+                                       (unsigned char *)batch.data()) ==
+          table_ratio);
+    CHECK(fsst_probe_compression_ratio(encoder, batch.size(),
+                                       (unsigned char *)batch.data(), 100) > 0);
+    CHECK(fsst_probe_compression_ratio(encoder, 0,
+                                       (unsigned char *)batch.data()) == 0);
+  }
+
+  fsst_destroy(encoder);
+}
@@ -0,0 +1,215 @@
+// Library includes
+using namespace std;
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../fsst/sampling.h"
+
+// ---------------------------------------------------------------------------------------------
+// Function-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are foccused on testing the functionality of a single function
+
+TEST_CASE("sample_lines")
+{
+  // Build a batch of lines of different lengths (the position of a sampled
+  // line is found by its address within the batch)
+  string batch;
+  vector<size_t> begins;
+  for (unsigned int i = 0; i < 1000; i++)
+  {
+    begins.push_back(batch.size());
+    batch += "LINE" + to_string(i) + string(i % 7, 'X') + "\n";
+  }
+  vector<string_view> lines = split_string_by_newline(batch);
+  REQUIRE(lines.size() == 1000);
+
+  auto position = [&](string_view line)
+  { return (size_t)(line.data() - batch.data()); };
+
+  SUBCASE("Equal seeds draw equal samples")
+  {
+    for (SamplingMode sampling :
+         {RESERVOIR_SAMPLING, STRATIFIED_SAMPLING, BYTE_BUDGET_SAMPLING})
+    {
+      vector<string_view> sample = sample_lines(lines, 50, sampling, 7, 500);
+      CHECK(sample == sample_lines(lines, 50, sampling, 7, 500));
+      CHECK(sample != sample_lines(lines, 50, sampling, 8, 500));
+    }
+  }
+
+  SUBCASE("No line is drawn twice")
+  {
+    for (SamplingMode sampling : {RESERVOIR_SAMPLING, BYTE_BUDGET_SAMPLING})
+    {
+      vector<string_view> sample = sample_lines(lines, 200, sampling, 3, 5000);
+      set<size_t> positions;
+      for (string_view line : sample)
+        positions.insert(position(line));
+      CHECK(sample.size() == 200);
+      CHECK(positions.size() == sample.size());
+    }
+  }
+
+  SUBCASE("Every stratum is covered")
+  {
+    vector<string_view> sample =
+        sample_lines(lines, 30, STRATIFIED_SAMPLING, 11);
+    REQUIRE(sample.size() == 30);
+
+    // The k-th line is drawn from the k-th range of lines
+    for (size_t k = 0; k < sample.size(); k++)
+    {
+      size_t begin = lines.size() * k / 30;
+      size_t end = lines.size() * (k + 1) / 30;
+      CHECK(position(sample[k]) >= begins[begin]);
+      CHECK(position(sample[k]) < begins[end - 1] + lines[end - 1].size());
+    }
+  }
+
+  SUBCASE("The byte budget is respected")
+  {
+    // Lines are drawn until the target is reached, but not beyond twice of it
+    vector<string_view> sample =
+        sample_lines(lines, SIZE_MAX, BYTE_BUDGET_SAMPLING, 5, 100);
+    size_t bytes = 0;
+    for (string_view line : sample)
+      bytes += line.size();
+    CHECK(bytes >= 100);
+    CHECK(bytes - sample.back().size() < 100);
+    CHECK(bytes <= 200);
+
+    // A line longer than twice the target is truncated
+    string long_line(1000, 'L');
+    vector<string_view> long_lines = {long_line};
+    sample = sample_lines(long_lines, SIZE_MAX, BYTE_BUDGET_SAMPLING, 5, 100);
+    REQUIRE(sample.size() == 1);
+    CHECK(sample[0] == string_view(long_line).substr(0, 200));
+
+    // At most n_samples lines are drawn
+    CHECK(sample_lines(lines, 3, BYTE_BUDGET_SAMPLING, 5, 100000).size() == 3);
+  }
+
+  SUBCASE("All lines are taken if there are not more than to sample")
+  {
+    for (size_t n_samples : {lines.size(), lines.size() + 1, (size_t)SIZE_MAX})
+    {
+      CHECK(sample_lines(lines, n_samples, RESERVOIR_SAMPLING) == lines);
+      CHECK(sample_lines(lines, n_samples, STRATIFIED_SAMPLING) == lines);
+    }
+
+    // The byte budget takes every line (in random order) if it is not reached
+    vector<string_view> sample =
+        sample_lines(lines, SIZE_MAX, BYTE_BUDGET_SAMPLING, 5, batch.size());
+    set<size_t> positions;
+    for (string_view line : sample)
+      positions.insert(position(line));
+    CHECK(sample.size() == lines.size());
+    CHECK(positions.size() == lines.size());
+  }
+}
+
+TEST_CASE("split_string_by_newline")
+{
+  // Split a batch byte by byte
+  auto split_scalar = [](string_view str)
+  {
+    vector<string_view> lines;
+    size_t begin = 0;
+    for (size_t pos = 0; pos < str.size(); pos++)
+      if (str[pos] == '\n')
+      {
+        lines.push_back(str.substr(begin, pos - begin));
+        begin = pos + 1;
+      }
+    if (begin < str.size())
+      lines.push_back(str.substr(begin));
+    return lines;
+  };
+
+  // The lines have to be views into the batch itself
+  auto check_split = [&](string_view str)
+  {
+    vector<string_view> lines = split_string_by_newline(str);
+    vector<string_view> expected = split_scalar(str);
+    REQUIRE(lines.size() == expected.size());
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+      CHECK(lines[i].data() == expected[i].data());
+      CHECK(lines[i].size() == expected[i].size());
+    }
+  };
+
+  SUBCASE("Lines crossing the 16 and 32 byte blocks")
+  {
+    string batch;
+    for (unsigned int i = 0; i < 40; i++)
+      batch += string(i % 13 + 5, 'A' + i % 26) + "\n";
+    check_split(batch);
+    check_split(string_view(batch).substr(3));
+  }
+
+  SUBCASE("Newlines at the last byte of a block")
+  {
+    for (size_t last : {15, 31, 47, 63})
+    {
+      string batch(64, 'A');
+      batch[last] = '\n';
+      check_split(batch);
+    }
+    check_split(string(16, '\n'));
+    check_split(string(15, 'A') + "\n" + string(15, 'A') + "\n" +
+                string(31, 'B') + "\n");
+  }
+
+  SUBCASE("Empty lines and consecutive newlines")
+  {
+    check_split("\n");
+    check_split("\n\nA\n\n\nB\n\n");
+    check_split(string(100, '\n'));
+    CHECK(split_string_by_newline("A\n\nB").size() == 3);
+  }
+
+  SUBCASE("Embedded NUL bytes")
+  {
+    string batch = string("A\0B\n\0\0\n", 7) + string(40, '\0') + "\nC";
+    check_split(batch);
+    CHECK(split_string_by_newline(batch)[0] == string_view("A\0B", 3));
+  }
+
+  SUBCASE("Batches with and without a trailing newline")
+  {
+    for (string batch : {string(50, 'A') + "\nB", string(50, 'A') + "\nB\n"})
+      check_split(batch);
+    CHECK(split_string_by_newline("A\nB\n").size() == 2);
+    CHECK(split_string_by_newline("A\nB").size() == 2);
+  }
+
+  SUBCASE("Batches shorter than a block")
+  {
+    check_split("");
+    check_split("A");
+    check_split("A\nB");
+    check_split(string(15, 'A') + "\n");
+    CHECK(split_string_by_newline("").empty());
+  }
+
+  SUBCASE("Every batch of up to 70 bytes with a newline every k bytes")
+  {
+    for (size_t length = 0; length <= 70; length++)
+      for (size_t k = 1; k <= 17; k++)
+      {
+        string batch(length, 'A');
+        for (size_t pos = k - 1; pos < length; pos += k)
+          batch[pos] = '\n';
+        check_split(batch);
+      }
+  }
+}
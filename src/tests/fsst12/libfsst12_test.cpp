@@ -0,0 +1,142 @@
+// Library includes
+using namespace std;
+#include <string>
+#include <vector>
+
+// Doctest include
+#include "../doctest/doctest.h"
+
+// Include the files to test
+#include "../../fsst/fsst12.h"
+
+// ---------------------------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @brief Compresses strings with an FSST12 encoder and decompresses them again
+ * with the decoder FSST12 exports for it (the encoder is destroyed).
+ * @param encoder The encoder.
+ * @param strings The strings.
+ * @return The decompressed strings.
+ */
+static vector<string> round_trip(fsst_encoder_t *encoder,
+                                 const vector<string> &strings)
+{
+  // Compress the strings
+  vector<unsigned long> lens;
+  vector<unsigned char *> strs;
+  size_t total = 0;
+  for (const string &str : strings)
+  {
+    lens.push_back(str.size());
+    strs.push_back((unsigned char *)str.data());
+    total += str.size();
+  }
+  vector<unsigned char> output(7 + 2 * total);
+  vector<unsigned long> lenOut(strings.size());
+  vector<unsigned char *> strOut(strings.size());
+  unsigned long compressed =
+      fsst_compress(encoder, strings.size(), lens.data(), strs.data(),
+                    output.size(), output.data(), lenOut.data(), strOut.data());
+  REQUIRE(compressed == strings.size());
+
+  // Decompress them through an exported and imported dictionary
+  vector<unsigned char> header(FSST_MAXHEADER);
+  fsst_export(encoder, header.data());
+  fsst_decoder_t *decoder = new fsst_decoder_t();
+  fsst_import(decoder, header.data());
+  fsst_destroy(encoder);
+
+  vector<string> decompressed;
+  for (size_t i = 0; i < strings.size(); i++)
+  {
+    // Decompress into a tight and into a large buffer (the decoder takes a
+    // different path if the output is almost full)
+    for (size_t slack : {0, 64})
+    {
+      vector<unsigned char> buffer(strings[i].size() + slack);
+      size_t len = fsst_decompress(decoder, lenOut[i], strOut[i],
+                                   buffer.size(), buffer.data());
+      if (slack == 0)
+        CHECK(string((const char *)buffer.data(), len) == strings[i]);
+      else
+        decompressed.emplace_back((const char *)buffer.data(), len);
+    }
+  }
+  delete decoder;
+  return decompressed;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Function-level tests
+// ---------------------------------------------------------------------------------------------
+// Tests are foccused on testing the functionality of a single function
+
+TEST_CASE("fsst12_create_with_fst")
+{
+  // Build strings with frequent substrings of every length (so they are
+  // coded with an odd and an even number of codes)
+  vector<string> strings;
+  for (unsigned int i = 0; i < 500; i++)
+    strings.push_back(string(i % 9, 'a') + "https://www." +
+                      string(i % 4, 'w') + "example" +
+                      to_string(i * 7919 % 1000) + ".com/" +
+                      (i % 50 == 0 ? "\xff\x01" : ""));
+  for (string str : {"", "a", "ab", "abc", "q", "qq", "qqq"})
+    strings.push_back(str);
+
+  SUBCASE("Strings that are not zero-terminated")
+  {
+    vector<size_t> lens;
+    vector<unsigned char *> strs;
+    for (string &str : strings)
+    {
+      lens.push_back(str.size());
+      strs.push_back((unsigned char *)str.data());
+    }
+
+    for (FST::CountingBackend backend :
+         {FST::SUFFIX_TRIE, FST::SUFFIX_ARRAY, FST::SPACE_SAVING})
+    {
+      fsst_encoder_t *encoder = fsst12_create_with_fst(
+          strings.size(), lens.data(), strs.data(), 0, 7, backend);
+      CHECK(round_trip(encoder, strings) == strings);
+    }
+  }
+
+  SUBCASE("Zero-terminated strings")
+  {
+    // The terminating zero byte belongs to every string
+    vector<string> terminated;
+    for (const string &str : strings)
+      terminated.push_back(str + '\0');
+
+    vector<size_t> lens;
+    vector<unsigned char *> strs;
+    for (string &str : terminated)
+    {
+      lens.push_back(str.size());
+      strs.push_back((unsigned char *)str.data());
+    }
+
+    fsst_encoder_t *encoder = fsst12_create_with_fst(
+        terminated.size(), lens.data(), strs.data(), 1);
+    CHECK(round_trip(encoder, terminated) == terminated);
+  }
+
+  SUBCASE("Dictionaries of FSST12 itself")
+  {
+    vector<unsigned long> lens;
+    vector<unsigned char *> strs;
+    for (string &str : strings)
+    {
+      lens.push_back(str.size());
+      strs.push_back((unsigned char *)str.data());
+    }
+
+    fsst_encoder_t *encoder =
+        fsst_create(strings.size(), lens.data(), strs.data(), 0);
+    CHECK(round_trip(encoder, strings) == strings);
+  }
+}
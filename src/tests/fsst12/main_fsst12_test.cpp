@@ -0,0 +1,4 @@
+// General Doctest configuration (the tests of the library fsst12 have a
+// program of their own, see CMakeLists.txt)
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest/doctest.h"
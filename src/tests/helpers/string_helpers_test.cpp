@@ -3,7 +3,10 @@ using namespace std;
 #include <iostream>
 #include <set>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 // Doctest include
 #include "../doctest/doctest.h"
@@ -360,6 +363,45 @@ TEST_CASE("string_helpers::delete_contained_substrings")
   }
 }
 
+TEST_CASE("string_helpers::delete_contained_substrings with counts")
+{
+  SUBCASE("TESTESTEST, TESTEST and TEST")
+  {
+    // Create the inital list of strings with their number of copies
+    vector<pair<string_view, unsigned int>> strings = {
+        {"TEST", 3}, {"TESTEST", 2}, {"TESTESTEST", 1}};
+
+    // Create the expected list of strings
+    vector<pair<string_view, unsigned int>> expected_strings = {
+        {"TESTESTEST", 1}, {"TESTEST", 1}, {"TEST", 1}};
+
+    // Delete the contained strings
+    CHECK(string_helpers::delete_contained_substrings(strings) ==
+          expected_strings);
+  }
+
+  SUBCASE("Same strings as without counts")
+  {
+    // Create the inital list of strings
+    list<string> strings = {"TESTER", "TESTER", "STER", "TEST",
+                            "TEST",   "TEST",   "EST",  "ST"};
+    vector<pair<string_view, unsigned int>> counted_strings = {
+        {"TESTER", 2}, {"STER", 1}, {"TEST", 3}, {"EST", 1}, {"ST", 1}};
+
+    // Delete the contained strings in both representations
+    list<string> expected_strings =
+        string_helpers::delete_contained_substrings(strings);
+    list<string> returned_strings;
+    for (pair<string_view, unsigned int> str :
+         string_helpers::delete_contained_substrings(counted_strings))
+      returned_strings.insert(returned_strings.end(), str.second,
+                              string(str.first));
+
+    // Check if the lists are the same (in the same order)
+    CHECK(returned_strings == expected_strings);
+  }
+}
+
 TEST_CASE("string_helpers::get_substrings_to_delete")
 {
   SUBCASE("TESTESTEST and TESTER with string to replace TEST")